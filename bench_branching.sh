@@ -0,0 +1,92 @@
+#!/bin/bash
+# Benchmark the native search's branching rules on a (k, p) grid
+# Usage: ./bench_branching.sh [K PRIME]...
+#   RULES="support wdeg"  rules to compare (default: all of them)
+#   FLAGS="--table"       extra flags for every run
+#   TIMEOUT=300           seconds per run; slower runs count as timeouts
+# Prints nodes and search time per rule, then the fastest rule per k by
+# total search time over that k's cases (a timeout counts as TIMEOUT).
+# Runs with GNU tools or stock macOS (bash 3.2, BSD userland, perl).
+
+CASES=("$@")
+if [ ${#CASES[@]} -eq 0 ]; then
+    CASES=(4 17 4 31 5 23 5 31 6 31 8 31 8 37)
+fi
+RULES=(${RULES:-support marginal wdeg dual entropy})
+TIMEOUT=${TIMEOUT:-300}
+
+# timeout(1) is GNU coreutils; elsewhere perl's alarm does the same
+if command -v timeout > /dev/null; then
+    limit() { timeout "$@"; }
+else
+    limit() { perl -e 'alarm shift; exec @ARGV' "$@"; }
+fi
+
+# "<result> <nodes> <seconds>" for one rule on the compiled instance
+run_rule() {
+    local rule=$1
+    limit $TIMEOUT ./native_bench --branch $rule $FLAGS > bench_result.txt 2> bench_log.txt
+    local result="TIMEOUT"
+    if grep -q "^s UNSATISFIABLE" bench_result.txt; then
+        result="UNSAT"
+    elif grep -q "^s SATISFIABLE" bench_result.txt; then
+        result="SAT"
+    fi
+    local search=$(grep "^Search:" bench_log.txt)
+    local nodes=$(echo "$search" | awk '{ print $2 }')
+    local seconds=$(echo "$search" | awk '{ sub("s$", "", $NF); printf "%.3f", $NF }')
+    echo "$result ${nodes:--} ${seconds:-$TIMEOUT}"
+}
+
+echo "============================================"
+echo "Branching benchmark: ${RULES[*]}"
+echo "============================================"
+printf "%-4s %-5s %-6s" "k" "p" "result"
+for rule in "${RULES[@]}"; do printf " | %10s %9s" "$rule" "seconds"; done
+printf "\n"
+
+# Per rule r, total_r[k] is the rule's search seconds summed over k's cases
+# (indexed arrays: bash 3.2 has no associative ones)
+for rule in "${RULES[@]}"; do eval "total_$rule=()"; done
+total() { eval "echo \${total_$1[$2]}"; }
+for ((i = 0; i < ${#CASES[@]}; i += 2)); do
+    k=${CASES[i]}
+    p=${CASES[i + 1]}
+    g++ -O3 -march=native -pthread -DK=$k -DPRIME=$p -o native_bench src/lonely_native_search.cpp 2>/dev/null || {
+        echo "$k $p compile-error"
+        continue
+    }
+    row=""
+    verdict=""
+    for rule in "${RULES[@]}"; do
+        r=($(run_rule $rule))
+        row+=$(printf " | %10s %8ss" ${r[1]} ${r[2]})
+        sum=$(total $rule $k)
+        eval "total_$rule[$k]=$(awk "BEGIN { print ${sum:-0} + ${r[2]} }")"
+        if [ "${r[0]}" != "TIMEOUT" ]; then
+            if [ -n "$verdict" ] && [ "$verdict" != "${r[0]}" ]; then
+                echo "  ❌ $rule disagrees on k=$k p=$p"
+            fi
+            verdict=${r[0]}
+        fi
+    done
+    printf "%-4s %-5s %-6s%s\n" $k $p ${verdict:-TIMEOUT} "$row"
+done
+
+echo ""
+echo "Fastest rule per k (total search seconds):"
+for k in $(for ((i = 0; i < ${#CASES[@]}; i += 2)); do echo ${CASES[i]}; done | sort -n -u); do
+    best=""
+    for rule in "${RULES[@]}"; do
+        [ -z "$(total $rule $k)" ] && continue
+        if [ -z "$best" ] || awk "BEGIN { exit !($(total $rule $k) < $(total $best $k)) }"; then best=$rule; fi
+    done
+    [ -z "$best" ] && continue
+    printf "  k=%-3s %-9s %8.3fs" $k $best $(total $best $k)
+    for rule in "${RULES[@]}"; do
+        [ -n "$(total $rule $k)" ] && printf "  %s %.3f" $rule $(total $rule $k)
+    done
+    printf "\n"
+done
+
+rm -f native_bench bench_result.txt bench_log.txt
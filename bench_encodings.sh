@@ -0,0 +1,56 @@
+#!/bin/bash
+# Benchmark the two exactly-k encodings on the README performance set
+# Usage: ./bench_encodings.sh [K PRIME]...
+#   counter: one Boolean per candidate + sequential counter (default build)
+#   slots:   k ordered slots with ladder/channeling (-DSLOT_ENCODING)
+
+CASES=("$@")
+if [ ${#CASES[@]} -eq 0 ]; then
+    CASES=(4 17 4 31 5 23 5 31 6 31 8 31 8 37)
+fi
+
+run_case() {
+    local k=$1
+    local p=$2
+    local flags=$3
+
+    g++ -O3 -march=native -pthread $flags -DK=$k -DPRIME=$p -o gen_bench src/lonely_cnf_generator.cpp 2>/dev/null || {
+        echo "compile-error 0 0 0"
+        return
+    }
+    ./gen_bench 2>/dev/null > bench_temp.cnf
+    local header=($(head -1 bench_temp.cnf))
+
+    local start=$(date +%s.%N)
+    ./solver/kissat --quiet bench_temp.cnf > bench_result.txt 2>&1
+    local end=$(date +%s.%N)
+
+    local result="UNKNOWN"
+    if grep -q "^s UNSATISFIABLE" bench_result.txt; then
+        result="UNSAT"
+    elif grep -q "^s SATISFIABLE" bench_result.txt; then
+        result="SAT"
+    fi
+    echo "$result ${header[2]} ${header[3]} $(awk "BEGIN { printf \"%.3f\", $end - $start }")"
+}
+
+echo "============================================"
+echo "Encoding benchmark: counter vs slots"
+echo "============================================"
+printf "%-4s %-5s | %-6s %7s %8s %9s | %-6s %7s %8s %9s | %s\n" \
+    "k" "p" "result" "vars" "clauses" "counter" "result" "vars" "clauses" "slots" "ratio"
+
+for ((i = 0; i < ${#CASES[@]}; i += 2)); do
+    k=${CASES[i]}
+    p=${CASES[i + 1]}
+    c=($(run_case $k $p ""))
+    s=($(run_case $k $p "-DSLOT_ENCODING"))
+    ratio=$(awk "BEGIN { if (${s[3]} > 0) printf \"%.2fx\", ${c[3]} / ${s[3]}; else print \"-\" }")
+    printf "%-4s %-5s | %-6s %7s %8s %8ss | %-6s %7s %8s %8ss | %s\n" \
+        $k $p ${c[0]} ${c[1]} ${c[2]} ${c[3]} ${s[0]} ${s[1]} ${s[2]} ${s[3]} $ratio
+    if [ "${c[0]}" != "${s[0]}" ]; then
+        echo "  ❌ encodings disagree"
+    fi
+done
+
+rm -f gen_bench bench_temp.cnf bench_result.txt
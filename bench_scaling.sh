@@ -0,0 +1,248 @@
+#!/bin/bash
+# Strong- and weak-scaling benchmark for the parallel components
+# Usage: ./bench_scaling.sh [K PRIME]...
+#   THREADS="1 2 4 8"   thread counts (default: powers of two up to the core count)
+#   COMPONENTS="..."    subset of: dominance native cubes sls batch
+#   THRESHOLD=0.5       flag runs whose parallel efficiency is below this
+#   TIMEOUT=300         seconds per run; slower runs count as timeouts
+#   REPEATS=1           runs per point; the fastest one is kept
+#   OUT=bench_scaling   writes OUT.csv and OUT.json
+#
+# Components and the time each is measured by:
+#   dominance  velocity + time dominance ("Time:" lines); serial in this
+#              tree, so it runs once per case as the Amdahl floor
+#   native     native search, --threads N ("Search:" line)
+#   cubes      in-tree CDCL cube-and-conquer, --solve --threads N ("CDCL:")
+#   sls        local search, --threads N, SAT cases only ("Local search:")
+#   batch      CNF generation for all cases, N concurrent processes (wall)
+# Per case and thread count the table gives seconds, speedup over 1 thread,
+# efficiency (speedup / N) and peak RSS from the tools' "Memory:" line; plot
+# them against maxM for the size axis. batch also runs weak scaling: each of
+# the N processes generates the whole case list, so ideal time is flat and
+# the efficiency is T(1) / T(N). batch rows carry the largest maxM of the
+# list, and their RSS sums the N largest process peaks.
+# Runs with GNU tools or stock macOS (bash 3.2, BSD userland, perl).
+
+CASES=("$@")
+if [ ${#CASES[@]} -eq 0 ]; then
+    CASES=(4 17 5 23 6 17 8 31)
+fi
+CORES=$(nproc 2>/dev/null || sysctl -n hw.ncpu)
+if [ -z "$THREADS" ]; then
+    THREADS="1"
+    for ((t = 2; t <= CORES; t *= 2)); do THREADS+=" $t"; done
+fi
+THREADS=($THREADS)
+COMPONENTS=" ${COMPONENTS:-dominance native cubes sls batch} "
+THRESHOLD=${THRESHOLD:-0.5}
+TIMEOUT=${TIMEOUT:-300}
+REPEATS=${REPEATS:-1}
+OUT=${OUT:-bench_scaling}
+
+MOST=${THREADS[${#THREADS[@]} - 1]}
+if [ $MOST -gt $CORES ]; then
+    echo "Note: $MOST threads on $CORES cores oversubscribes; efficiency will drop"
+fi
+
+# timeout(1) is GNU coreutils; elsewhere perl's alarm does the same
+if command -v timeout > /dev/null; then
+    limit() { timeout "$@"; }
+else
+    limit() { perl -e 'alarm shift; exec @ARGV' "$@"; }
+fi
+
+# Wall clock in seconds (date +%s.%N is GNU only)
+now() {
+    if [ -n "$EPOCHREALTIME" ]; then
+        echo "${EPOCHREALTIME/,/.}"
+    else
+        perl -MTime::HiRes=time -e 'printf "%.6f\n", time'
+    fi
+}
+
+echo "component,k,p,maxM,threads,result,seconds,speedup,efficiency,rss_mb" > $OUT.csv
+flagged=()
+
+# "<seconds> <rss>" from a tool's stderr, given the timing line's prefix
+parse_log() {
+    local log=$1 prefix=$2
+    local seconds=$(grep "^$prefix" $log | tail -1 | awk '{ sub("s$", "", $NF); print $NF }')
+    local rss=$(grep "^Memory:" $log | tail -1 | awk '{ print $4 }')
+    echo "${seconds:--} ${rss:--}"
+}
+
+verdict() {
+    if grep -q "^s UNSATISFIABLE" $1; then
+        echo UNSAT
+    elif grep -q "^s SATISFIABLE" $1; then
+        echo SAT
+    else
+        echo TIMEOUT
+    fi
+}
+
+# Record one point; base is the 1-thread time of the same series
+record() {
+    local component=$1 k=$2 p=$3 maxM=$4 threads=$5 result=$6 seconds=$7 rss=$8 base=$9
+    local speedup=- efficiency=-
+    if [ "$result" != "TIMEOUT" ] && [ "$seconds" != "-" ] && [ -n "$base" ]; then
+        speedup=$(awk "BEGIN { printf \"%.2f\", $base / ($seconds > 1e-6 ? $seconds : 1e-6) }")
+        # Weak scaling: ideal is flat, so the efficiency is the speedup itself
+        if [ "$component" = "batch-weak" ]; then
+            efficiency=$speedup
+        else
+            efficiency=$(awk "BEGIN { printf \"%.2f\", $speedup / $threads }")
+        fi
+        if [ $threads -gt 1 ] && awk "BEGIN { exit !($efficiency < $THRESHOLD) }"; then
+            flagged+=("$component k=$k p=$p: efficiency $efficiency at $threads threads")
+        fi
+    fi
+    [ "$seconds" != "-" ] && seconds=$(awk "BEGIN { printf \"%.4f\", $seconds }")
+    [ "$rss" != "-" ] && rss=$(awk "BEGIN { printf \"%.1f\", $rss }")
+    echo "$component,$k,$p,$maxM,$threads,$result,$seconds,$speedup,$efficiency,$rss" >> $OUT.csv
+    printf "%-10s %-4s %-5s %6s %4s %-7s %9s %8s %6s %9s\n" \
+        $component $k $p $maxM $threads $result $seconds $speedup $efficiency $rss
+}
+
+# Best of REPEATS runs: "<result> <seconds> <rss>"
+run_threaded() {
+    local prefix=$1
+    shift
+    local best="" bestRss="-" result=TIMEOUT
+    for ((r = 0; r < REPEATS; ++r)); do
+        limit $TIMEOUT "$@" > scaling_out.txt 2> scaling_log.txt
+        local res=$(verdict scaling_out.txt)
+        local m=($(parse_log scaling_log.txt "$prefix"))
+        [ "$res" = "TIMEOUT" ] && continue
+        result=$res
+        if [ -z "$best" ] || awk "BEGIN { exit !(${m[0]} < $best) }"; then best=${m[0]}; fi
+        if [ "$bestRss" = "-" ] || awk "BEGIN { exit !(${m[1]} > $bestRss) }"; then bestRss=${m[1]}; fi
+    done
+    echo "$result ${best:-$TIMEOUT} $bestRss"
+}
+
+# Run jobs (one binary each) with at most N at a time: "<seconds> <rss>"
+run_batch() {
+    local jobs=$1
+    shift
+    local start=$(now)
+    local i=0
+    for bin in "$@"; do
+        echo "$i $bin"
+        i=$((i + 1))
+    done | xargs -P $jobs -n 2 sh -c './$1 > /dev/null 2> scaling_batch_$0.txt'
+    local end=$(now)
+    local rss=$(cat scaling_batch_*.txt | grep "^Memory:" | awk '{ print $4 }' | sort -g -r | head -n $jobs |
+                awk '{ s += $1 } END { printf "%.1f", s }')
+    rm -f scaling_batch_*.txt
+    echo "$(awk "BEGIN { printf \"%.3f\", $end - $start }") $rss"
+}
+
+echo "============================================"
+echo "Scaling benchmark: threads ${THREADS[*]}"
+echo "============================================"
+printf "%-10s %-4s %-5s %6s %4s %-7s %9s %8s %6s %9s\n" \
+    "component" "k" "p" "maxM" "thr" "result" "seconds" "speedup" "eff" "rss_mb"
+
+generators=()
+for ((i = 0; i < ${#CASES[@]}; i += 2)); do
+    k=${CASES[i]}
+    p=${CASES[i + 1]}
+    maxM=$(((k + 1) * p / 2))
+    gen=scaling_gen_${k}_$p
+    g++ -O3 -march=native -pthread -DK=$k -DPRIME=$p -o $gen src/lonely_cnf_generator.cpp 2>/dev/null &&
+    g++ -O3 -march=native -pthread -DK=$k -DPRIME=$p -o scaling_native src/lonely_native_search.cpp 2>/dev/null &&
+    g++ -O3 -march=native -pthread -DK=$k -DPRIME=$p -o scaling_sls src/lonely_local_search.cpp 2>/dev/null || {
+        echo "$k $p compile-error"
+        continue
+    }
+    generators+=($gen)
+
+    if [[ $COMPONENTS == *" dominance "* ]]; then
+        limit $TIMEOUT ./$gen > /dev/null 2> scaling_log.txt
+        seconds=$(grep "^  Time:" scaling_log.txt | awk '{ sub("s$", "", $2); s += $2 } END { printf "%.6f", s }')
+        rss=$(grep "^Memory:" scaling_log.txt | awk '{ print $4 }')
+        result=$([ -n "$rss" ] && echo done || echo TIMEOUT)
+        record dominance $k $p $maxM 1 $result $seconds ${rss:--} ""
+    fi
+
+    known=""
+    for component in native cubes; do
+        [[ $COMPONENTS == *" $component "* ]] || continue
+        base=""
+        for threads in "${THREADS[@]}"; do
+            if [ $component = native ]; then
+                r=($(run_threaded "Search:" ./scaling_native --threads $threads))
+            else
+                r=($(run_threaded "CDCL:" ./$gen --solve --threads $threads))
+            fi
+            [ $threads -eq 1 ] && [ "${r[0]}" != "TIMEOUT" ] && base=${r[1]}
+            if [ "${r[0]}" != "TIMEOUT" ]; then
+                if [ -n "$known" ] && [ "$known" != "${r[0]}" ]; then
+                    echo "  ❌ $component disagrees on k=$k p=$p"
+                fi
+                known=${r[0]}
+            fi
+            record $component $k $p $maxM $threads ${r[0]} ${r[1]} ${r[2]} "$base"
+        done
+    done
+
+    # Local search only terminates on satisfiable cases
+    if [[ $COMPONENTS == *" sls "* ]] && [ "$known" != "UNSAT" ]; then
+        base=""
+        for threads in "${THREADS[@]}"; do
+            r=($(run_threaded "Local search:" ./scaling_sls --threads $threads --seconds $TIMEOUT --seed 1))
+            [ "${r[0]}" = "SAT" ] || r[0]=TIMEOUT
+            [ $threads -eq 1 ] && [ "${r[0]}" != "TIMEOUT" ] && base=${r[1]}
+            record sls $k $p $maxM $threads ${r[0]} ${r[1]} ${r[2]} "$base"
+        done
+    fi
+done
+
+if [[ $COMPONENTS == *" batch "* ]] && [ ${#generators[@]} -gt 0 ]; then
+    largest=0
+    for gen in "${generators[@]}"; do
+        g=(${gen//_/ })
+        m=$(((g[2] + 1) * g[3] / 2))
+        [ $m -gt $largest ] && largest=$m
+    done
+    # Strong: the case list over N processes
+    base=""
+    for threads in "${THREADS[@]}"; do
+        r=($(run_batch $threads "${generators[@]}"))
+        [ $threads -eq 1 ] && base=${r[0]}
+        record batch - - $largest $threads done ${r[0]} ${r[1]} "$base"
+    done
+    # Weak: the whole case list per process
+    base=""
+    for threads in "${THREADS[@]}"; do
+        list=()
+        for ((j = 0; j < threads; ++j)); do list+=("${generators[@]}"); done
+        r=($(run_batch $threads "${list[@]}"))
+        [ $threads -eq 1 ] && base=${r[0]}
+        record batch-weak - - $largest $threads done ${r[0]} ${r[1]} "$base"
+    done
+fi
+
+# JSON: one object per CSV row, numbers unquoted, "-" as null
+awk -F, 'NR == 1 { for (i = 1; i <= NF; ++i) key[i] = $i; print "["; next }
+    {
+        printf "%s  {", (NR > 2 ? ",\n" : "")
+        for (i = 1; i <= NF; ++i) {
+            v = ($i ~ /^[0-9.]+$/) ? $i : ($i == "-") ? "null" : "\"" $i "\""
+            printf "%s\"%s\": %s", (i > 1 ? ", " : ""), key[i], v
+        }
+        printf "}"
+    }
+    END { print "\n]" }' $OUT.csv > $OUT.json
+
+echo ""
+if [ ${#flagged[@]} -eq 0 ]; then
+    echo "✅ All efficiencies at or above $THRESHOLD"
+else
+    echo "Efficiency below $THRESHOLD:"
+    for f in "${flagged[@]}"; do echo "  ⚠️  $f"; done
+fi
+echo "Wrote $OUT.csv and $OUT.json"
+
+rm -f scaling_gen_* scaling_native scaling_sls scaling_out.txt scaling_log.txt
@@ -0,0 +1,588 @@
+// Microbenchmarks for the bit kernels behind preprocessing and search
+//
+// Rows are bit vectors of W = ceil(bits/64) words, one per candidate, with as
+// many rows as bits (the instances are square: maxM x maxM).
+//   popcount   |row| for every row                      (UncoveredSet::count)
+//   or         dst = a | b                              (cover unions)
+//   andnot     dst = a & ~b                             (UncoveredSet::subtract)
+//   dominance  b ⊆ a over row pairs, full scan          (dominatesVelocity)
+//   transpose  candidate-major -> time-major            (buildCoverageSets)
+// Each kernel has scalar, AVX2 and AVX-512 variants picked at run time, so
+// one binary measures all of them; variants the CPU lacks are skipped. Off
+// x86-64 (e.g. arm64) only the scalar variants are built.
+//
+// Per row width (default 100..20000 bits) and thread count the table gives
+// GB/s of operand traffic, 64-bit word operations per TSC cycle, and the
+// share of a roof that depends on the kernel's footprint (its operand bytes):
+//   cache  footprint within the last-level cache: the best bandwidth any
+//          streaming kernel (read, or, andnot) sustained on the same
+//          matrices with the same threads
+//   dram   footprint above it: a streaming read over a buffer of at least
+//          4x the last-level cache, measured once per thread count
+// Kernels at 70% of their roof or more are marked with its name (bound by
+// that level's bandwidth); the others are "cpu", limited by instructions and
+// helped by better code rather than smaller data. The scalar popcount uses
+// the POPCNT instruction where the CPU has it (every x86-64-v2 part).
+//
+// g++ -O3 -pthread -o bench_kernels src/bench_kernels.cpp
+// ./bench_kernels [--threads 1,2,4] [--bits 100,1000,20000] [--ms 50]
+//                 [--llc-mb N] [--dram-mb N]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#if defined(__APPLE__)
+#include <sys/sysctl.h>
+#endif
+#if defined(__x86_64__)
+#include <immintrin.h>
+#include <x86intrin.h>
+#endif
+using namespace std;
+
+#define TARGET_POPCNT __attribute__((target("popcnt")))
+#define TARGET_AVX2 __attribute__((target("avx2,popcnt")))
+#define TARGET_AVX512 __attribute__((target("avx512f,avx512bw,avx512vpopcntdq,popcnt")))
+
+enum Variant { Scalar, Avx2, Avx512, NumVariants };
+static const char* variantNames[NumVariants] = { "scalar", "avx2", "avx512" };
+
+bool variantSupported(Variant v) {
+#if !defined(__x86_64__)
+    return v == Scalar;
+#endif
+    if (v == Avx2) return __builtin_cpu_supports("avx2");
+    if (v == Avx512) {
+        return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") &&
+               __builtin_cpu_supports("avx512vpopcntdq");
+    }
+    return true;
+}
+
+// Rows padded to 8 words so every variant runs without a tail loop
+struct BitMatrix {
+    int rows = 0;
+    int words = 0;      // payload words per row
+    int stride = 0;     // padded words per row
+    vector<uint64_t> data;
+
+    BitMatrix(int r, int bits) : rows(r), words((bits + 63) / 64), stride((words + 7) / 8 * 8) {
+        data.assign((size_t)rows * stride, 0);
+    }
+    uint64_t* row(int i) { return &data[(size_t)i * stride]; }
+    const uint64_t* row(int i) const { return &data[(size_t)i * stride]; }
+};
+
+// Kernels: each processes rows [lo, hi)
+
+#if defined(__x86_64__)
+TARGET_POPCNT uint64_t popcountInstruction(const BitMatrix& m, int lo, int hi) {
+    uint64_t total = 0;
+    for (int i = lo; i < hi; ++i) {
+        const uint64_t* r = m.row(i);
+        for (int w = 0; w < m.stride; ++w) total += __builtin_popcountll(r[w]);
+    }
+    return total;
+}
+#endif
+
+// Without -mpopcnt, __builtin_popcountll is a software bit count on x86
+uint64_t popcountScalar(const BitMatrix& m, int lo, int hi) {
+#if defined(__x86_64__)
+    if (__builtin_cpu_supports("popcnt")) return popcountInstruction(m, lo, hi);
+#endif
+    uint64_t total = 0;
+    for (int i = lo; i < hi; ++i) {
+        const uint64_t* r = m.row(i);
+        for (int w = 0; w < m.stride; ++w) total += __builtin_popcountll(r[w]);
+    }
+    return total;
+}
+
+#if defined(__x86_64__)
+TARGET_AVX2 uint64_t popcountAvx2(const BitMatrix& m, int lo, int hi) {
+    // Nibble lookup with pshufb, summed per 64-bit lane by psadbw
+    const __m256i lut = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                         0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low = _mm256_set1_epi8(0x0f);
+    __m256i acc = _mm256_setzero_si256();
+    for (int i = lo; i < hi; ++i) {
+        const uint64_t* r = m.row(i);
+        for (int w = 0; w < m.stride; w += 4) {
+            __m256i x = _mm256_loadu_si256((const __m256i*)(r + w));
+            __m256i c = _mm256_add_epi8(_mm256_shuffle_epi8(lut, _mm256_and_si256(x, low)),
+                                        _mm256_shuffle_epi8(lut, _mm256_and_si256(_mm256_srli_epi16(x, 4), low)));
+            acc = _mm256_add_epi64(acc, _mm256_sad_epu8(c, _mm256_setzero_si256()));
+        }
+    }
+    alignas(32) uint64_t lanes[4];
+    _mm256_store_si256((__m256i*)lanes, acc);
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3];
+}
+
+TARGET_AVX512 uint64_t popcountAvx512(const BitMatrix& m, int lo, int hi) {
+    __m512i acc = _mm512_setzero_si512();
+    for (int i = lo; i < hi; ++i) {
+        const uint64_t* r = m.row(i);
+        for (int w = 0; w < m.stride; w += 8) {
+            acc = _mm512_add_epi64(acc, _mm512_popcnt_epi64(_mm512_loadu_si512((const void*)(r + w))));
+        }
+    }
+    alignas(64) uint64_t lanes[8];
+    _mm512_store_si512((void*)lanes, acc);
+    uint64_t total = 0;
+    for (uint64_t x : lanes) total += x;
+    return total;
+}
+#endif
+
+// dst[i] = a[i] op b[i]; op 0 = or, 1 = andnot
+void binaryScalar(const BitMatrix& a, const BitMatrix& b, BitMatrix& dst, int op, int lo, int hi) {
+    for (int i = lo; i < hi; ++i) {
+        const uint64_t* x = a.row(i);
+        const uint64_t* y = b.row(i);
+        uint64_t* d = dst.row(i);
+        if (op == 0) for (int w = 0; w < a.stride; ++w) d[w] = x[w] | y[w];
+        else for (int w = 0; w < a.stride; ++w) d[w] = x[w] & ~y[w];
+    }
+}
+
+#if defined(__x86_64__)
+TARGET_AVX2 void binaryAvx2(const BitMatrix& a, const BitMatrix& b, BitMatrix& dst, int op, int lo, int hi) {
+    for (int i = lo; i < hi; ++i) {
+        const uint64_t* x = a.row(i);
+        const uint64_t* y = b.row(i);
+        uint64_t* d = dst.row(i);
+        for (int w = 0; w < a.stride; w += 4) {
+            __m256i u = _mm256_loadu_si256((const __m256i*)(x + w));
+            __m256i v = _mm256_loadu_si256((const __m256i*)(y + w));
+            __m256i r = op == 0 ? _mm256_or_si256(u, v) : _mm256_andnot_si256(v, u);
+            _mm256_storeu_si256((__m256i*)(d + w), r);
+        }
+    }
+}
+
+TARGET_AVX512 void binaryAvx512(const BitMatrix& a, const BitMatrix& b, BitMatrix& dst, int op, int lo, int hi) {
+    for (int i = lo; i < hi; ++i) {
+        const uint64_t* x = a.row(i);
+        const uint64_t* y = b.row(i);
+        uint64_t* d = dst.row(i);
+        for (int w = 0; w < a.stride; w += 8) {
+            __m512i u = _mm512_loadu_si512((const void*)(x + w));
+            __m512i v = _mm512_loadu_si512((const void*)(y + w));
+            __m512i r = op == 0 ? _mm512_or_si512(u, v) : _mm512_ternarylogic_epi64(u, v, v, 0x30);
+            _mm512_storeu_si512((void*)(d + w), r);
+        }
+    }
+}
+#endif
+
+// Row i of sub is a subset of row i of a, so every test scans the whole row
+// (the worst case of dominatesVelocity); returns the number of subset pairs
+uint64_t dominanceScalar(const BitMatrix& a, const BitMatrix& sub, int lo, int hi) {
+    uint64_t hits = 0;
+    for (int i = lo; i < hi; ++i) {
+        const uint64_t* x = a.row(i);
+        const uint64_t* y = sub.row(i);
+        bool subset = true;
+        for (int w = 0; w < a.stride && subset; ++w) subset = (y[w] & ~x[w]) == 0;
+        hits += subset;
+    }
+    return hits;
+}
+
+#if defined(__x86_64__)
+TARGET_AVX2 uint64_t dominanceAvx2(const BitMatrix& a, const BitMatrix& sub, int lo, int hi) {
+    uint64_t hits = 0;
+    for (int i = lo; i < hi; ++i) {
+        const uint64_t* x = a.row(i);
+        const uint64_t* y = sub.row(i);
+        bool subset = true;
+        for (int w = 0; w < a.stride && subset; w += 4) {
+            __m256i u = _mm256_loadu_si256((const __m256i*)(x + w));
+            __m256i v = _mm256_loadu_si256((const __m256i*)(y + w));
+            subset = _mm256_testc_si256(u, v);   // (v & ~u) == 0
+        }
+        hits += subset;
+    }
+    return hits;
+}
+
+TARGET_AVX512 uint64_t dominanceAvx512(const BitMatrix& a, const BitMatrix& sub, int lo, int hi) {
+    uint64_t hits = 0;
+    for (int i = lo; i < hi; ++i) {
+        const uint64_t* x = a.row(i);
+        const uint64_t* y = sub.row(i);
+        bool subset = true;
+        for (int w = 0; w < a.stride && subset; w += 8) {
+            __m512i u = _mm512_loadu_si512((const void*)(x + w));
+            __m512i v = _mm512_loadu_si512((const void*)(y + w));
+            subset = _mm512_testn_epi64_mask(v, _mm512_xor_si512(u, _mm512_set1_epi64(-1))) == 0xff;
+        }
+        hits += subset;
+    }
+    return hits;
+}
+#endif
+
+// Transpose: out.row(t) bit j = in.row(j) bit t; threads split the input
+// rows in blocks of 64 so their output words never overlap
+void transposeScalar(const BitMatrix& in, BitMatrix& out, int lo, int hi) {
+    for (int t = 0; t < out.rows; ++t) {
+        uint64_t* o = out.row(t);
+        for (int j = lo; j < hi; ++j) {
+            if (in.row(j)[t >> 6] >> (t & 63) & 1) o[j >> 6] |= 1ULL << (j & 63);
+        }
+    }
+}
+
+#if defined(__x86_64__)
+// Byte column c of 32 (or 64) rows -> movemask per bit position gives one
+// 32-bit (64-bit) chunk of eight output rows
+TARGET_AVX2 void transposeAvx2(const BitMatrix& in, BitMatrix& out, int lo, int hi) {
+    alignas(32) uint8_t column[32];
+    int bytes = in.words * 8;
+    for (int j0 = lo; j0 < hi; j0 += 32) {
+        int rows = min(32, hi - j0);
+        for (int c = 0; c < bytes; ++c) {
+            for (int r = 0; r < 32; ++r) column[r] = r < rows ? ((const uint8_t*)in.row(j0 + r))[c] : 0;
+            __m256i x = _mm256_load_si256((const __m256i*)column);
+            for (int s = 7; s >= 0; --s) {
+                int t = c * 8 + s;
+                uint32_t mask = (uint32_t)_mm256_movemask_epi8(x);
+                x = _mm256_add_epi8(x, x);
+                if (t < out.rows) ((uint32_t*)out.row(t))[j0 >> 5] = mask;
+            }
+        }
+    }
+}
+
+TARGET_AVX512 void transposeAvx512(const BitMatrix& in, BitMatrix& out, int lo, int hi) {
+    alignas(64) uint8_t column[64];
+    int bytes = in.words * 8;
+    for (int j0 = lo; j0 < hi; j0 += 64) {
+        int rows = min(64, hi - j0);
+        for (int c = 0; c < bytes; ++c) {
+            for (int r = 0; r < 64; ++r) column[r] = r < rows ? ((const uint8_t*)in.row(j0 + r))[c] : 0;
+            __m512i x = _mm512_load_si512((const void*)column);
+            for (int s = 7; s >= 0; --s) {
+                int t = c * 8 + s;
+                uint64_t mask = _mm512_movepi8_mask(x);
+                x = _mm512_add_epi8(x, x);
+                if (t < out.rows) out.row(t)[j0 >> 6] = mask;
+            }
+        }
+    }
+}
+#endif
+
+// Roof: streaming read of the same working set. Four independent
+// accumulators, so the read is never bound by the xor latency chain
+uint64_t readScalar(const BitMatrix& m, int lo, int hi) {
+    uint64_t x0 = 0, x1 = 0, x2 = 0, x3 = 0;
+    for (int i = lo; i < hi; ++i) {
+        const uint64_t* r = m.row(i);
+        for (int w = 0; w < m.stride; w += 4) {
+            x0 ^= r[w];
+            x1 ^= r[w + 1];
+            x2 ^= r[w + 2];
+            x3 ^= r[w + 3];
+        }
+    }
+    return x0 ^ x1 ^ x2 ^ x3;
+}
+
+#if defined(__x86_64__)
+TARGET_AVX512 uint64_t readAvx512(const BitMatrix& m, int lo, int hi) {
+    __m512i acc = _mm512_setzero_si512(), acc2 = _mm512_setzero_si512();
+    for (int i = lo; i < hi; ++i) {
+        const uint64_t* r = m.row(i);
+        int w = 0;
+        for (; w + 16 <= m.stride; w += 16) {
+            acc = _mm512_xor_si512(acc, _mm512_loadu_si512((const void*)(r + w)));
+            acc2 = _mm512_xor_si512(acc2, _mm512_loadu_si512((const void*)(r + w + 8)));
+        }
+        if (w < m.stride) acc = _mm512_xor_si512(acc, _mm512_loadu_si512((const void*)(r + w)));
+    }
+    acc = _mm512_xor_si512(acc, acc2);
+    alignas(64) uint64_t lanes[8];
+    _mm512_store_si512((void*)lanes, acc);
+    uint64_t x = 0;
+    for (uint64_t y : lanes) x ^= y;
+    return x;
+}
+
+TARGET_AVX2 uint64_t readAvx2(const BitMatrix& m, int lo, int hi) {
+    __m256i acc = _mm256_setzero_si256(), acc2 = _mm256_setzero_si256();
+    for (int i = lo; i < hi; ++i) {
+        const uint64_t* r = m.row(i);
+        for (int w = 0; w < m.stride; w += 8) {
+            acc = _mm256_xor_si256(acc, _mm256_loadu_si256((const __m256i*)(r + w)));
+            acc2 = _mm256_xor_si256(acc2, _mm256_loadu_si256((const __m256i*)(r + w + 4)));
+        }
+    }
+    acc = _mm256_xor_si256(acc, acc2);
+    alignas(32) uint64_t lanes[4];
+    _mm256_store_si256((__m256i*)lanes, acc);
+    return lanes[0] | lanes[1] | lanes[2] | lanes[3];
+}
+#endif
+
+#if !defined(__x86_64__)
+// Never selected (variantSupported); keeps the dispatch below compiling
+#define popcountAvx2 popcountScalar
+#define popcountAvx512 popcountScalar
+#define binaryAvx2 binaryScalar
+#define binaryAvx512 binaryScalar
+#define dominanceAvx2 dominanceScalar
+#define dominanceAvx512 dominanceScalar
+#define transposeAvx2 transposeScalar
+#define transposeAvx512 transposeScalar
+#define readAvx2 readScalar
+#define readAvx512 readScalar
+#endif
+
+// Timing
+
+volatile uint64_t sink;
+
+// TSC cycles on x86-64; elsewhere there is no user-space cycle counter, so
+// the "cycles" are steady_clock nanoseconds and the column is ops/ns
+#if defined(__x86_64__)
+const char* cycleUnit = "ops/cycle";
+uint64_t cycleCount() { return __rdtsc(); }
+#else
+const char* cycleUnit = "ops/ns";
+uint64_t cycleCount() {
+    return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+#endif
+
+struct Measure {
+    double seconds;
+    double cycles;
+};
+
+// Calibrate a repetition count on one thread (at least minSeconds), then
+// run body(lo, hi) that many times per thread over [0, rows) split in
+// align-sized chunks; best of three, per repetition
+Measure timeKernel(int rows, int threads, int align, double minSeconds,
+                   const function<uint64_t(int, int)>& body) {
+    long long reps = 0;
+    auto start = chrono::steady_clock::now();
+    do {
+        sink = sink + body(0, rows);
+        ++reps;
+    } while (chrono::duration<double>(chrono::steady_clock::now() - start).count() < minSeconds);
+
+    int chunk = ((rows + threads - 1) / threads + align - 1) / align * align;
+    auto work = [&](int t) {
+        int lo = min(rows, t * chunk), hi = min(rows, lo + chunk);
+        uint64_t x = 0;
+        for (long long r = 0; r < reps; ++r) x += body(lo, hi);
+        sink = sink + x;
+    };
+
+    Measure best = { 1e30, 1e30 };
+    for (int trial = 0; trial < 3; ++trial) {
+        auto t0 = chrono::steady_clock::now();
+        uint64_t c0 = cycleCount();
+        if (threads == 1) {
+            work(0);
+        } else {
+            vector<thread> pool;
+            for (int t = 0; t < threads; ++t) pool.emplace_back(work, t);
+            for (auto& p : pool) p.join();
+        }
+        uint64_t c1 = cycleCount();
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+        if (seconds / reps < best.seconds) best = { seconds / reps, (double)(c1 - c0) / reps };
+    }
+    return best;
+}
+
+// Last-level cache size in bytes, 0 if the OS does not say
+size_t lastLevelCacheBytes() {
+#if defined(__APPLE__)
+    // Apple silicon has no L3; its shared L2 is the last level
+    for (const char* key : { "hw.l3cachesize", "hw.perflevel0.l2cachesize", "hw.l2cachesize" }) {
+        uint64_t bytes = 0;
+        size_t size = sizeof(bytes);
+        if (sysctlbyname(key, &bytes, &size, nullptr, 0) == 0 && bytes > 0) return bytes;
+    }
+#elif defined(_SC_LEVEL3_CACHE_SIZE)
+    for (int key : { _SC_LEVEL3_CACHE_SIZE, _SC_LEVEL2_CACHE_SIZE }) {
+        long bytes = sysconf(key);
+        if (bytes > 0) return bytes;
+    }
+#endif
+    return 0;
+}
+
+uint64_t readBest(const BitMatrix& m, int lo, int hi) {
+    if (variantSupported(Avx512)) return readAvx512(m, lo, hi);
+    if (variantSupported(Avx2)) return readAvx2(m, lo, hi);
+    return readScalar(m, lo, hi);
+}
+
+vector<int> parseList(const string& s) {
+    vector<int> out;
+    stringstream in(s);
+    string item;
+    while (getline(in, item, ',')) out.push_back(atoi(item.c_str()));
+    return out;
+}
+
+int main(int argc, char** argv) {
+    vector<int> widths = { 100, 300, 1000, 3000, 10000, 20000 };
+    vector<int> threadCounts = { 1 };
+    double minSeconds = 0.05;
+    double llcMB = lastLevelCacheBytes() / 1e6, dramMB = 0;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--llc-mb" && i + 1 < argc) llcMB = atof(argv[++i]);
+        if (arg == "--dram-mb" && i + 1 < argc) dramMB = atof(argv[++i]);
+        if (arg == "--bits" && i + 1 < argc) widths = parseList(argv[++i]);
+        if (arg == "--threads" && i + 1 < argc) threadCounts = parseList(argv[++i]);
+        if (arg == "--ms" && i + 1 < argc) minSeconds = atof(argv[++i]) / 1000.0;
+    }
+
+    cerr << "Variants:";
+    for (int v = 0; v < NumVariants; ++v) {
+        if (variantSupported((Variant)v)) cerr << " " << variantNames[v];
+    }
+    cerr << "\n";
+    if (llcMB <= 0) llcMB = 32;   // unknown: assume a large server LLC
+    if (dramMB <= 0) dramMB = max(4 * llcMB, 256.0);
+
+    // DRAM roof per thread count: rows of 8192 bits over dramMB
+    vector<double> dramRoof;
+    {
+        BitMatrix big((int)(dramMB * 1e6 / 1024), 8192);
+        for (size_t i = 0; i < big.data.size(); ++i) big.data[i] = i * 0x9e3779b97f4a7c15ULL;
+        for (int threads : threadCounts) {
+            Measure m = timeKernel(big.rows, threads, 1, minSeconds, [&](int lo, int hi) {
+                return readBest(big, lo, hi);
+            });
+            dramRoof.push_back((double)big.rows * 1024 / m.seconds / 1e9);
+        }
+    }
+    cerr << "Last-level cache: " << llcMB << " MB; DRAM roof over " << dramMB << " MB:";
+    for (size_t t = 0; t < threadCounts.size(); ++t) {
+        cerr << " " << dramRoof[t] << " GB/s (" << threadCounts[t] << " thr)";
+    }
+    cerr << "\n";
+
+    printf("%-10s %-7s %6s %4s %10s %9s %10s %8s %6s\n",
+           "kernel", "variant", "bits", "thr", "MB", "GB/s", cycleUnit, "roof%", "bound");
+
+    mt19937_64 rng(12345);
+    for (int bits : widths) {
+        BitMatrix a(bits, bits), sub(bits, bits), dst(bits, bits), out(bits, bits);
+        for (int i = 0; i < bits; ++i) {
+            for (int w = 0; w < a.words; ++w) {
+                // Density ~1/4 like nearZero rows; sub is a subset of a
+                uint64_t x = rng() & rng();
+                if (w == a.words - 1 && bits % 64) x &= (1ULL << (bits % 64)) - 1;
+                a.row(i)[w] = x;
+                sub.row(i)[w] = x & rng();
+            }
+        }
+        double rowBytes = (double)a.stride * 8;
+        double setMB = rowBytes * bits / 1e6;
+
+        for (size_t ti = 0; ti < threadCounts.size(); ++ti) {
+            int threads = threadCounts[ti];
+            struct Row {
+                string kernel;
+                Variant variant;
+                double gbs;
+                double opc;
+                bool streaming;
+                bool inCache;     // footprint within the last-level cache
+            };
+            vector<Row> rows;
+
+            for (int v = 0; v < NumVariants; ++v) {
+                if (!variantSupported((Variant)v)) continue;
+                Variant var = (Variant)v;
+
+                struct Case {
+                    const char* name;
+                    double bytesPerRow;   // operand traffic
+                    double opsPerRow;     // 64-bit word operations
+                    int align;
+                    bool streaming;       // candidate for the roof
+                    function<uint64_t(int, int)> body;
+                };
+                vector<Case> cases = {
+                    { "read", rowBytes, (double)a.stride, 1, true, [&](int lo, int hi) {
+                        return var == Scalar ? readScalar(a, lo, hi)
+                             : var == Avx2 ? readAvx2(a, lo, hi) : readAvx512(a, lo, hi);
+                    } },
+                    { "popcount", rowBytes, (double)a.stride, 1, false, [&](int lo, int hi) {
+                        return var == Scalar ? popcountScalar(a, lo, hi)
+                             : var == Avx2 ? popcountAvx2(a, lo, hi) : popcountAvx512(a, lo, hi);
+                    } },
+                    { "or", 3 * rowBytes, (double)a.stride, 1, true, [&](int lo, int hi) {
+                        if (var == Scalar) binaryScalar(a, sub, dst, 0, lo, hi);
+                        else if (var == Avx2) binaryAvx2(a, sub, dst, 0, lo, hi);
+                        else binaryAvx512(a, sub, dst, 0, lo, hi);
+                        return (uint64_t)dst.row(lo)[0];
+                    } },
+                    { "andnot", 3 * rowBytes, (double)a.stride, 1, true, [&](int lo, int hi) {
+                        if (var == Scalar) binaryScalar(a, sub, dst, 1, lo, hi);
+                        else if (var == Avx2) binaryAvx2(a, sub, dst, 1, lo, hi);
+                        else binaryAvx512(a, sub, dst, 1, lo, hi);
+                        return (uint64_t)dst.row(lo)[0];
+                    } },
+                    { "dominance", 2 * rowBytes, (double)a.stride, 1, false, [&](int lo, int hi) {
+                        return var == Scalar ? dominanceScalar(a, sub, lo, hi)
+                             : var == Avx2 ? dominanceAvx2(a, sub, lo, hi) : dominanceAvx512(a, sub, lo, hi);
+                    } },
+                    { "transpose", 2 * rowBytes, (double)a.words, 64, false, [&](int lo, int hi) {
+                        if (var == Scalar) transposeScalar(a, out, lo, hi);
+                        else if (var == Avx2) transposeAvx2(a, out, lo, hi);
+                        else transposeAvx512(a, out, lo, hi);
+                        return (uint64_t)out.row(0)[0];
+                    } },
+                };
+
+                for (const Case& c : cases) {
+                    // The bit-by-bit transpose is quadratic per row; skip the
+                    // sizes where a single repetition would take seconds
+                    if (var == Scalar && string(c.name) == "transpose" && bits > 3000) continue;
+                    Measure m = timeKernel(bits, threads, c.align, minSeconds, c.body);
+                    double footprintMB = c.bytesPerRow * bits / 1e6;
+                    rows.push_back({ c.name, var, c.bytesPerRow * bits / m.seconds / 1e9,
+                                     c.opsPerRow * bits / m.cycles, c.streaming, footprintMB <= llcMB });
+                }
+            }
+
+            // Cache roof: best streaming bandwidth at this size and thread
+            // count among the kernels whose footprint stays in cache
+            double cacheRoof = 0;
+            for (const Row& r : rows) {
+                if (r.streaming && r.inCache) cacheRoof = max(cacheRoof, r.gbs);
+            }
+            for (const Row& r : rows) {
+                bool cached = r.inCache && cacheRoof > 0;
+                double share = 100.0 * r.gbs / (cached ? cacheRoof : dramRoof[ti]);
+                printf("%-10s %-7s %6d %4d %10.3f %9.2f %10.3f %8.1f %6s\n",
+                       r.kernel.c_str(), variantNames[r.variant], bits, threads, setMB, r.gbs, r.opc, share,
+                       share < 70.0 ? "cpu" : cached ? "cache" : "dram");
+            }
+        }
+    }
+    return 0;
+}
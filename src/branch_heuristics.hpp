@@ -0,0 +1,29 @@
+// Branching heuristics for the native search
+//
+// Every rule picks the uncovered time to branch on; the node then tries all
+// available candidates covering it, most new coverage first, so any choice
+// keeps the search (and its certificates) complete. Rules differ only in
+// which time they expose first:
+//   support   fewest available candidates (Rosenfeld's rule, default)
+//   marginal  the best-scoring candidate first, at its least-covered time
+//   wdeg      support divided by a failure weight learned per time
+//   dual      largest Lagrangian price λ_t (turns on --lagrange)
+//   entropy   among the two lowest support levels, the time whose coverers'
+//             scores are most concentrated
+
+#pragma once
+
+#include <string>
+using namespace std;
+
+enum BranchRule { BranchSupport, BranchMarginal, BranchWdeg, BranchDual, BranchEntropy, NumBranchRules };
+
+static const char* branchRuleNames[NumBranchRules] = { "support", "marginal", "wdeg", "dual", "entropy" };
+
+// NumBranchRules if the name is unknown
+inline BranchRule parseBranchRule(const string& name) {
+    for (int r = 0; r < NumBranchRules; ++r) {
+        if (name == branchRuleNames[r]) return (BranchRule)r;
+    }
+    return NumBranchRules;
+}
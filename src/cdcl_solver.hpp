@@ -0,0 +1,792 @@
+// Compact CDCL solver with clauses tagged by origin
+//
+// MiniSat-style: two watched literals with blockers, 1UIP learning with
+// local minimization, VSIDS, phase saving, Luby restarts and LBD-based
+// reduction of learnt clauses. Every clause carries a group id, and per group
+// the solver counts the conflicts it raised, the literals it propagated and
+// how often it was resolved on while deriving learnt clauses, so search effort
+// can be attributed to parts of the encoding. Learnt clauses form group 0.
+// Learnt clauses can be exported and re-imported as redundant clauses, so an
+// interrupted run can resume from a checkpoint taken between restarts.
+// An external propagator (IPASIR-UP style) can watch variables, imply
+// literals with reason clauses and add clauses during the search, so a
+// constraint need not be clausified up front.
+// The interface uses DIMACS literals (±var, vars from 1).
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+using namespace std;
+
+// Callbacks of an external propagator. The solver reports assignments of
+// observed variables (at the current decision level, in trail order), new
+// decision levels and backtracks. After unit propagation it asks for
+// clauses and implied literals until neither is left. A clause may have any
+// status: a conflicting one is analyzed like any other conflict. Reasons
+// are lazy: reason(lit) is asked only when conflict analysis reaches an
+// implied literal (or at once, if it is already false), and must return
+// a clause with lit and otherwise literals that were false when lit was
+// implied; a reason of lit alone makes it a fact, asserted at level 0 on
+// the next return there. Reasons and added clauses are kept as learnt clauses of the
+// propagator's group, so they may be deleted and derived again. When
+// every variable is assigned, checkModel either accepts the model or
+// returns false after queuing a clause that the model falsifies.
+class ExternalPropagator {
+public:
+    virtual ~ExternalPropagator() = default;
+    virtual void notifyAssignment(const vector<int>& lits) = 0;
+    virtual void notifyNewDecisionLevel() = 0;
+    virtual void notifyBacktrack(int newLevel) = 0;
+    // An implied literal, or 0
+    virtual int propagate() = 0;
+    virtual vector<int> reason(int lit) = 0;
+    // False when no clause is queued
+    virtual bool externalClause(vector<int>& clause) = 0;
+    // model: one DIMACS literal per variable
+    virtual bool checkModel(const vector<int>& model) = 0;
+};
+
+class CDCLSolver {
+public:
+    static constexpr int kLearnedGroup = 0;
+    static constexpr int kSat = 10, kUnsat = 20, kUnknown = 0;
+
+    struct GroupStats {
+        string name;
+        long long clauses = 0;
+        long long conflicts = 0;
+        long long propagations = 0;
+        long long antecedents = 0;
+    };
+
+    long long conflicts = 0;
+    long long decisions = 0;
+    long long propagations = 0;
+    long long restarts = 0;
+
+    CDCLSolver() { groups.push_back({ "learned" }); }
+
+    int numVars() const { return (int)level.size(); }
+
+    int newVar() {
+        int v = numVars();
+        litVal.push_back(0);
+        litVal.push_back(0);
+        level.push_back(0);
+        reason.push_back(-1);
+        seen.push_back(0);
+        activity.push_back(0.0);
+        phase.push_back(0);
+        observed.push_back(0);
+        heapPos.push_back(-1);
+        watches.emplace_back();
+        watches.emplace_back();
+        heapInsert(v);
+        return v + 1;
+    }
+
+    void reserveVars(int n) {
+        while (numVars() < n) newVar();
+    }
+
+    int addGroup(const string& name) {
+        groups.push_back({ name });
+        return (int)groups.size() - 1;
+    }
+
+    const vector<GroupStats>& groupStats() const { return groups; }
+
+    // Returns false once the formula is unsatisfiable at level 0
+    bool addClause(const vector<int>& dimacs, int group) {
+        cancelUntil(0);
+        ++groups[group].clauses;
+        if (!ok) return false;
+
+        vector<int> lits;
+        if (!normalize(dimacs, lits)) return true;   // satisfied
+        if (lits.empty()) return ok = false;
+        if (lits.size() == 1) {
+            enqueue(lits[0], -1);
+            ++groups[group].propagations;
+            return ok = propagate() < 0;
+        }
+        attach(lits, group, false);
+        return true;
+    }
+
+    // kSat, kUnsat (under the assumptions) or kUnknown when the conflict
+    // budget runs out; budget < 0 means no limit
+    int solve(const vector<int>& assumptions = {}, long long budget = -1) {
+        model.clear();
+        failed.clear();
+        if (!ok) return kUnsat;
+        assume.clear();
+        for (int x : assumptions) {
+            reserveVars(abs(x));
+            assume.push_back(toLit(x));
+        }
+        conflictLimit = budget < 0 ? -1 : conflicts + budget;
+
+        int status = -1;
+        for (int r = 0; status < 0; ++r) {
+            status = search(100 * luby(r));
+            // Restarts end at level 0, where the learnt clauses are stable
+            if (status < 0 && checkpoint && conflicts >= nextCheckpoint) {
+                checkpoint();
+                nextCheckpoint = conflicts + checkpointConflicts;
+            }
+        }
+        cancelUntil(0);
+        return status;
+    }
+
+    // Call f at the first restart after every `every` conflicts
+    void setCheckpoint(long long every, function<void()> f) {
+        checkpointConflicts = every;
+        nextCheckpoint = conflicts + every;
+        checkpoint = move(f);
+    }
+
+    // Learnt clauses with LBD at most maxLbd over variables 1..maxVar, plus
+    // the level-0 units on those variables
+    vector<vector<int>> learntClauses(int maxVar, int maxLbd) const {
+        vector<vector<int>> out;
+        size_t rootEnd = trailLim.empty() ? trail.size() : (size_t)trailLim[0];
+        for (size_t i = 0; i < rootEnd; ++i) {
+            if ((trail[i] >> 1) < maxVar) out.push_back({ toDimacs(trail[i]) });
+        }
+        for (const Clause& c : clauses) {
+            if (!c.learnt || c.deleted || c.lbd > maxLbd) continue;
+            vector<int> lits;
+            for (int m = 0; m < c.size; ++m) {
+                int l = arena[c.start + m];
+                if ((l >> 1) >= maxVar) break;
+                lits.push_back(toDimacs(l));
+            }
+            if ((int)lits.size() == c.size) out.push_back(move(lits));
+        }
+        return out;
+    }
+
+    // A clause implied by the formula, e.g. learnt by an earlier run; it is
+    // kept as a learnt clause with the given LBD and may be reduced later.
+    // Returns false once the formula is unsatisfiable at level 0.
+    bool addLearnt(const vector<int>& dimacs, int lbd) {
+        cancelUntil(0);
+        if (!ok) return false;
+        vector<int> lits;
+        if (!normalize(dimacs, lits)) return true;
+        ++groups[kLearnedGroup].clauses;
+        if (lits.empty()) return ok = false;
+        if (lits.size() == 1) {
+            enqueue(lits[0], -1);
+            return ok = propagate() < 0;
+        }
+        int cref = attach(lits, kLearnedGroup, true);
+        clauses[cref].lbd = min(lbd, (int)lits.size());
+        ++learntCount;
+        return true;
+    }
+
+    bool modelValue(int var) const { return model[var - 1]; }
+
+    // VSIDS activity, e.g. to pick a splitting variable
+    double activityOf(int var) const { return activity[var - 1]; }
+
+    // Assumptions (DIMACS) that together caused the last kUnsat
+    const vector<int>& failedAssumptions() const { return failed; }
+
+    // Attach p at level 0; its reasons and clauses are counted in group.
+    // Only observed variables are reported to it.
+    void connectPropagator(ExternalPropagator* p, int group) {
+        cancelUntil(0);
+        external = p;
+        externalGroup = group;
+        notified = 0;
+    }
+
+    void observe(int var) {
+        reserveVars(var);
+        observed[var - 1] = 1;
+    }
+
+private:
+    struct Clause {
+        int start;                     // literals are arena[start, start + size)
+        int size;
+        int group;
+        bool learnt;
+        bool deleted = false;
+        int lbd = 0;
+        double activity = 0.0;
+    };
+    struct Watcher {
+        int cref;
+        int blocker;
+    };
+
+    bool ok = true;
+    vector<GroupStats> groups;
+    vector<Clause> clauses;
+    vector<int> arena;
+    vector<vector<Watcher>> watches;   // watches[l]: clauses watching literal l
+    vector<int8_t> litVal;             // per literal: 1 true, -1 false, 0 unassigned
+    vector<int> level;
+    vector<int> reason;                // clause that propagated the variable, or -1
+    vector<char> seen;
+    vector<int> trail;
+    vector<int> trailLim;
+    size_t qhead = 0;
+    vector<int> assume;
+    vector<char> model;
+    vector<int> failed;
+    long long conflictLimit = -1;
+
+    vector<double> activity;
+    double varInc = 1.0;
+    double clauseInc = 1.0;
+    vector<char> phase;
+    vector<int> heap;
+    vector<int> heapPos;
+
+    long long learntCount = 0;
+    long long nextReduce = 2000;
+    long long reductions = 0;
+
+    function<void()> checkpoint;
+    long long checkpointConflicts = 0;
+    long long nextCheckpoint = 0;
+
+    ExternalPropagator* external = nullptr;
+    int externalGroup = kLearnedGroup;
+    vector<char> observed;
+    size_t notified = 0;               // trail entries reported to external
+    vector<int> factReason;            // per literal: its one-literal lazy reason, or -1
+    vector<int> pendingFacts;          // one-literal reasons not yet asserted at level 0
+
+    static int toLit(int x) { return 2 * (abs(x) - 1) + (x < 0); }
+
+    // Sorted literals without duplicates or level-0 false ones; false if the
+    // clause is already satisfied (level 0 or tautology)
+    bool normalize(const vector<int>& dimacs, vector<int>& lits) {
+        lits.clear();
+        for (int x : dimacs) {
+            reserveVars(abs(x));
+            lits.push_back(toLit(x));
+        }
+        sort(lits.begin(), lits.end());
+        size_t j = 0;
+        for (size_t i = 0; i < lits.size(); ++i) {
+            int l = lits[i];
+            if (litVal[l] == 1 || (j > 0 && lits[j - 1] == (l ^ 1))) return false;
+            if (litVal[l] == -1 || (j > 0 && lits[j - 1] == l)) continue;
+            lits[j++] = l;
+        }
+        lits.resize(j);
+        return true;
+    }
+    static int toDimacs(int l) { return (l & 1) ? -(l / 2 + 1) : l / 2 + 1; }
+
+    int decisionLevel() const { return (int)trailLim.size(); }
+
+    void enqueue(int l, int from) {
+        litVal[l] = 1;
+        litVal[l ^ 1] = -1;
+        level[l >> 1] = decisionLevel();
+        reason[l >> 1] = from;
+        trail.push_back(l);
+    }
+
+    int attach(const vector<int>& lits, int group, bool learnt) {
+        int cref = (int)clauses.size();
+        clauses.push_back({ (int)arena.size(), (int)lits.size(), group, learnt });
+        arena.insert(arena.end(), lits.begin(), lits.end());
+        watches[lits[0]].push_back({ cref, lits[1] });
+        watches[lits[1]].push_back({ cref, lits[0] });
+        return cref;
+    }
+
+    void newDecisionLevel() {
+        trailLim.push_back((int)trail.size());
+        if (external) external->notifyNewDecisionLevel();
+    }
+
+    void cancelUntil(int lvl) {
+        if (decisionLevel() <= lvl) return;
+        if (external) external->notifyBacktrack(lvl);
+        for (size_t i = trail.size(); i-- > (size_t)trailLim[lvl];) {
+            int v = trail[i] >> 1;
+            phase[v] = litVal[2 * v] == 1;
+            litVal[2 * v] = litVal[2 * v + 1] = 0;
+            reason[v] = -1;
+            if (heapPos[v] < 0) heapInsert(v);
+        }
+        trail.resize(trailLim[lvl]);
+        trailLim.resize(lvl);
+        qhead = trail.size();
+        notified = min(notified, trail.size());
+    }
+
+    // Clause from the external propagator, added during search. Literals
+    // are ordered true, unassigned, then false by decreasing level, so the
+    // watches sit on the two best. A unit clause is asserted at level 0, an
+    // asserting one after backjumping. Returns a conflicting clause (with
+    // two literals on the current level), or -1.
+    int addExternalClause(const vector<int>& dimacs) {
+        ++groups[externalGroup].clauses;
+        vector<int> lits;
+        for (int x : dimacs) {
+            reserveVars(abs(x));
+            int l = toLit(x);
+            if (level[l >> 1] == 0 && litVal[l] != 0) {
+                if (litVal[l] == 1) return -1;       // satisfied for good
+                continue;
+            }
+            lits.push_back(l);
+        }
+        sort(lits.begin(), lits.end());
+        lits.erase(unique(lits.begin(), lits.end()), lits.end());
+        for (size_t i = 1; i < lits.size(); ++i) {
+            if (lits[i] == (lits[i - 1] ^ 1)) return -1;
+        }
+        if (lits.empty()) {
+            ok = false;
+            return -1;
+        }
+        if (lits.size() == 1) {
+            cancelUntil(0);
+            enqueue(lits[0], -1);
+            ++groups[externalGroup].propagations;
+            return -1;
+        }
+        auto rank = [&](int l) { return litVal[l] == 1 ? INT32_MAX : litVal[l] == 0 ? INT32_MAX - 1 : level[l >> 1]; };
+        stable_sort(lits.begin(), lits.end(), [&](int a, int b) { return rank(a) > rank(b); });
+        if (litVal[lits[0]] == -1 && level[lits[1] >> 1] == level[lits[0] >> 1]) {
+            cancelUntil(level[lits[0] >> 1]);
+            int cref = attach(lits, externalGroup, true);
+            clauses[cref].lbd = computeLbd(lits);
+            ++learntCount;
+            return cref;
+        }
+        if (litVal[lits[0]] == -1) cancelUntil(level[lits[1] >> 1]);
+        int cref = attach(lits, externalGroup, true);
+        clauses[cref].lbd = computeLbd(lits);
+        ++learntCount;
+        if (litVal[lits[0]] == 0 && litVal[lits[1]] == -1) {
+            enqueue(lits[0], cref);
+            ++propagations;
+            ++groups[externalGroup].propagations;
+        }
+        return -1;
+    }
+
+    static constexpr int kLazyReason = -2;
+
+    // Reason clause of variable v, asking the propagator for a lazy one
+    int reasonOf(int v) {
+        if (reason[v] != kLazyReason) return reason[v];
+        int l = litVal[2 * v] == 1 ? 2 * v : 2 * v + 1;
+        vector<int> lits = { l };
+        for (int x : external->reason(toDimacs(l))) {
+            if (toLit(x) != l) lits.push_back(toLit(x));
+        }
+        // Watch the false literal assigned last
+        for (size_t i = 2; i < lits.size(); ++i) {
+            if (level[lits[i] >> 1] > level[lits[1] >> 1]) swap(lits[1], lits[i]);
+        }
+        if (lits.size() == 1) {
+            // A fact: an unwatched one-literal clause is its reason (no
+            // antecedents, unlike a decision), and it is asserted at level 0
+            // once the search gets back there
+            if (factReason.size() < 2 * (size_t)numVars()) factReason.resize(2 * numVars(), -1);
+            if (factReason[l] < 0) {
+                factReason[l] = (int)clauses.size();
+                clauses.push_back({ (int)arena.size(), 1, externalGroup, true });
+                clauses.back().lbd = 1;
+                arena.push_back(l);
+                ++groups[externalGroup].clauses;
+                pendingFacts.push_back(l);
+            }
+            reason[v] = factReason[l];
+            return reason[v];
+        }
+        int cref = attach(lits, externalGroup, true);
+        clauses[cref].lbd = computeLbd(lits);
+        ++learntCount;
+        ++groups[externalGroup].clauses;
+        reason[v] = cref;
+        return cref;
+    }
+
+    // Report new observed assignments, then take clauses and implied
+    // literals until the propagator has none or the trail grew. Returns a
+    // conflicting clause or -1; ok turns false on an empty clause.
+    int propagateExternal() {
+        vector<int> lits;
+        for (; notified < trail.size(); ++notified) {
+            if (observed[trail[notified] >> 1]) lits.push_back(toDimacs(trail[notified]));
+        }
+        if (!lits.empty()) external->notifyAssignment(lits);
+        vector<int> clause;
+        for (;;) {
+            int lit = 0;
+            if (!external->externalClause(clause)) {
+                lit = external->propagate();
+                if (lit == 0 && !external->externalClause(clause)) return -1;
+            }
+            if (lit != 0) {
+                int l = toLit(lit);
+                if (litVal[l] == 1) continue;
+                if (litVal[l] == 0) {
+                    enqueue(l, kLazyReason);
+                    ++propagations;
+                    ++groups[externalGroup].propagations;
+                    return -1;
+                }
+                clause = external->reason(lit);
+            }
+            int confl = addExternalClause(clause);
+            if (confl >= 0 || !ok) return confl;
+            if (qhead < trail.size()) return -1;
+        }
+    }
+
+    // Returns the conflicting clause, or -1
+    int propagate() {
+        while (qhead < trail.size()) {
+            int falseLit = trail[qhead++] ^ 1;
+            vector<Watcher>& ws = watches[falseLit];
+            size_t i = 0, j = 0;
+            while (i < ws.size()) {
+                Watcher w = ws[i++];
+                if (litVal[w.blocker] == 1) {
+                    ws[j++] = w;
+                    continue;
+                }
+                Clause& c = clauses[w.cref];
+                if (c.deleted) continue;
+                int* lits = &arena[c.start];
+                if (lits[0] == falseLit) swap(lits[0], lits[1]);
+                int first = lits[0];
+                Watcher kept = { w.cref, first };
+                if (first != w.blocker && litVal[first] == 1) {
+                    ws[j++] = kept;
+                    continue;
+                }
+
+                bool moved = false;
+                for (int m = 2; m < c.size; ++m) {
+                    if (litVal[lits[m]] != -1) {
+                        swap(lits[1], lits[m]);
+                        watches[lits[1]].push_back(kept);
+                        moved = true;
+                        break;
+                    }
+                }
+                if (moved) continue;
+
+                ws[j++] = kept;
+                if (litVal[first] == -1) {
+                    while (i < ws.size()) ws[j++] = ws[i++];
+                    ws.resize(j);
+                    qhead = trail.size();
+                    return w.cref;
+                }
+                enqueue(first, w.cref);
+                ++propagations;
+                ++groups[c.group].propagations;
+            }
+            ws.resize(j);
+        }
+        return -1;
+    }
+
+    // 1UIP clause in learnt (asserting literal first, highest other level second)
+    void analyze(int confl, vector<int>& learnt, int& backtrack) {
+        learnt.assign(1, -1);
+        int pathCount = 0, p = -1;
+        size_t index = trail.size();
+        do {
+            Clause& c = clauses[confl];
+            ++groups[c.group].antecedents;
+            if (c.learnt) bumpClause(c);
+            for (int m = 0; m < c.size; ++m) {
+                int q = arena[c.start + m];
+                if (q == p) continue;
+                int v = q >> 1;
+                if (seen[v] || level[v] == 0) continue;
+                seen[v] = 1;
+                bumpVar(v);
+                if (level[v] >= decisionLevel()) ++pathCount;
+                else learnt.push_back(q);
+            }
+            while (!seen[trail[--index] >> 1]) {}
+            p = trail[index];
+            seen[p >> 1] = 0;
+            --pathCount;
+            if (pathCount > 0) confl = reasonOf(p >> 1);
+        } while (pathCount > 0);
+        learnt[0] = p ^ 1;
+
+        // Drop literals implied by the rest of the clause
+        vector<int> marked(learnt.begin() + 1, learnt.end());
+        size_t j = 1;
+        for (size_t i = 1; i < learnt.size(); ++i) {
+            int r = reason[learnt[i] >> 1];
+            bool redundant = r >= 0;
+            for (int m = 1; redundant && m < clauses[r].size; ++m) {
+                int v = arena[clauses[r].start + m] >> 1;
+                redundant = seen[v] || level[v] == 0;
+            }
+            if (!redundant) learnt[j++] = learnt[i];
+        }
+        learnt.resize(j);
+        for (int q : marked) seen[q >> 1] = 0;
+
+        backtrack = 0;
+        for (size_t i = 1; i < learnt.size(); ++i) {
+            if (level[learnt[i] >> 1] > backtrack) {
+                backtrack = level[learnt[i] >> 1];
+                swap(learnt[1], learnt[i]);
+            }
+        }
+    }
+
+    // Assumptions responsible for literal p being false
+    void analyzeFinal(int p) {
+        failed.assign(1, toDimacs(p));
+        if (decisionLevel() == 0) return;
+        seen[p >> 1] = 1;
+        for (size_t i = trail.size(); i-- > (size_t)trailLim[0];) {
+            int v = trail[i] >> 1;
+            if (!seen[v]) continue;
+            int r = reasonOf(v);
+            if (r < 0) {
+                failed.push_back(toDimacs(trail[i]));
+            } else {
+                const Clause& c = clauses[r];
+                for (int m = 1; m < c.size; ++m) {
+                    int u = arena[c.start + m] >> 1;
+                    if (level[u] > 0) seen[u] = 1;
+                }
+            }
+            seen[v] = 0;
+        }
+        seen[p >> 1] = 0;
+        sort(failed.begin(), failed.end());
+        failed.erase(unique(failed.begin(), failed.end()), failed.end());
+    }
+
+    int computeLbd(const vector<int>& lits) {
+        vector<int> levels;
+        for (int l : lits) levels.push_back(level[l >> 1]);
+        sort(levels.begin(), levels.end());
+        return (int)(unique(levels.begin(), levels.end()) - levels.begin());
+    }
+
+    // -1 restart, otherwise a final status
+    int search(long long restartConflicts) {
+        vector<int> learnt;
+        for (long long local = 0;;) {
+            if (!pendingFacts.empty() && decisionLevel() == 0) {
+                for (int l : pendingFacts) {
+                    if (litVal[l] == -1) {
+                        ok = false;
+                        return kUnsat;
+                    }
+                    if (litVal[l] == 0) enqueue(l, -1);
+                }
+                pendingFacts.clear();
+            }
+            int confl = propagate();
+            if (confl < 0 && external) {
+                confl = propagateExternal();
+                if (!ok) return kUnsat;
+                if (confl < 0 && qhead < trail.size()) continue;
+            }
+            if (confl >= 0) {
+                ++conflicts;
+                ++local;
+                ++groups[clauses[confl].group].conflicts;
+                if (decisionLevel() == 0) {
+                    ok = false;
+                    return kUnsat;
+                }
+                int backtrack;
+                analyze(confl, learnt, backtrack);
+                cancelUntil(backtrack);
+                if (learnt.size() == 1) {
+                    enqueue(learnt[0], -1);
+                } else {
+                    int cref = attach(learnt, kLearnedGroup, true);
+                    clauses[cref].lbd = computeLbd(learnt);
+                    bumpClause(clauses[cref]);
+                    ++learntCount;
+                    enqueue(learnt[0], cref);
+                }
+                ++groups[kLearnedGroup].clauses;
+                varInc /= 0.95;
+                clauseInc /= 0.999;
+                continue;
+            }
+
+            if (conflictLimit >= 0 && conflicts >= conflictLimit) return kUnknown;
+            if (local >= restartConflicts) {
+                ++restarts;
+                cancelUntil(0);
+                return -1;
+            }
+            if (conflicts >= nextReduce) {
+                reduceLearnts();
+                nextReduce = conflicts + 2000 + 300 * ++reductions;
+            }
+
+            int next = -1;
+            while (decisionLevel() < (int)assume.size()) {
+                int p = assume[decisionLevel()];
+                if (litVal[p] == 1) {
+                    newDecisionLevel();   // already true: empty level
+                } else if (litVal[p] == -1) {
+                    analyzeFinal(p);
+                    return kUnsat;
+                } else {
+                    next = p;
+                    break;
+                }
+            }
+            if (next < 0) next = pickBranch();
+            if (next < 0 && external) {
+                vector<int> full(numVars());
+                for (int v = 0; v < numVars(); ++v) full[v] = litVal[2 * v] == 1 ? v + 1 : -(v + 1);
+                if (!external->checkModel(full)) continue;
+            }
+            if (next < 0) {
+                model.assign(numVars(), 0);
+                for (int v = 0; v < numVars(); ++v) model[v] = litVal[2 * v] == 1;
+                return kSat;
+            }
+            ++decisions;
+            newDecisionLevel();
+            enqueue(next, -1);
+        }
+    }
+
+    // Delete the less active half of the learnt clauses with LBD > 2
+    void reduceLearnts() {
+        vector<int> pool;
+        for (int c = 0; c < (int)clauses.size(); ++c) {
+            const Clause& cl = clauses[c];
+            if (!cl.learnt || cl.deleted || cl.lbd <= 2) continue;
+            int first = arena[cl.start];
+            if (reason[first >> 1] == c && litVal[first] == 1) continue;   // locked
+            pool.push_back(c);
+        }
+        sort(pool.begin(), pool.end(), [&](int a, int b) {
+            return clauses[a].activity < clauses[b].activity;
+        });
+        for (size_t i = 0; i < pool.size() / 2; ++i) {
+            clauses[pool[i]].deleted = true;
+            --learntCount;
+        }
+
+        // Compact the arena; watchers refer to clause indices, not offsets
+        vector<int> live;
+        live.reserve(arena.size());
+        for (Clause& c : clauses) {
+            if (c.deleted) continue;
+            int start = (int)live.size();
+            live.insert(live.end(), arena.begin() + c.start, arena.begin() + c.start + c.size);
+            c.start = start;
+        }
+        arena.swap(live);
+        for (auto& ws : watches) {
+            ws.erase(remove_if(ws.begin(), ws.end(), [&](const Watcher& w) {
+                return clauses[w.cref].deleted;
+            }), ws.end());
+        }
+    }
+
+    void bumpClause(Clause& c) {
+        c.activity += clauseInc;
+        if (c.activity > 1e20) {
+            for (auto& cl : clauses) cl.activity *= 1e-20;
+            clauseInc *= 1e-20;
+        }
+    }
+
+    void bumpVar(int v) {
+        activity[v] += varInc;
+        if (activity[v] > 1e100) {
+            for (double& a : activity) a *= 1e-100;
+            varInc *= 1e-100;
+        }
+        if (heapPos[v] >= 0) heapUp(heapPos[v]);
+    }
+
+    int pickBranch() {
+        while (!heap.empty()) {
+            int v = heapPop();
+            if (litVal[2 * v] == 0) return 2 * v + (phase[v] ? 0 : 1);
+        }
+        return -1;
+    }
+
+    static long long luby(int i) {
+        long long size = 1, seq = 0;
+        while (size < i + 1) size = 2 * size + 1, ++seq;
+        while (size - 1 != i) {
+            size = (size - 1) >> 1;
+            --seq;
+            i %= (int)size;
+        }
+        return 1LL << seq;
+    }
+
+    // Max-heap of variables by activity
+    void heapInsert(int v) {
+        heapPos[v] = (int)heap.size();
+        heap.push_back(v);
+        heapUp(heapPos[v]);
+    }
+
+    int heapPop() {
+        int top = heap[0];
+        heap[0] = heap.back();
+        heapPos[heap[0]] = 0;
+        heap.pop_back();
+        heapPos[top] = -1;
+        if (!heap.empty()) heapDown(0);
+        return top;
+    }
+
+    void heapUp(int i) {
+        int v = heap[i];
+        while (i > 0 && activity[heap[(i - 1) / 2]] < activity[v]) {
+            heap[i] = heap[(i - 1) / 2];
+            heapPos[heap[i]] = i;
+            i = (i - 1) / 2;
+        }
+        heap[i] = v;
+        heapPos[v] = i;
+    }
+
+    void heapDown(int i) {
+        int v = heap[i];
+        int size = (int)heap.size();
+        for (;;) {
+            int child = 2 * i + 1;
+            if (child >= size) break;
+            if (child + 1 < size && activity[heap[child + 1]] > activity[heap[child]]) ++child;
+            if (activity[heap[child]] <= activity[v]) break;
+            heap[i] = heap[child];
+            heapPos[heap[i]] = i;
+            i = child;
+        }
+        heap[i] = v;
+        heapPos[v] = i;
+    }
+};
@@ -0,0 +1,381 @@
+// Domain propagator for the covering problem (--propagator)
+//
+// Runs inside the CDCL solver through its external propagator interface and
+// takes the place of the coverage clauses, the exactly-k counter and the GCD
+// counters. It observes only the candidate variables. For every essential
+// time it counts the chosen coverers and the coverers not yet excluded.
+// For every prime q dividing n it counts the chosen multiples of q. Every
+// deduction is explained by a clause over the candidate variables:
+//   - an uncovered time with no coverer left is a conflict, and with one
+//     left that coverer is forced (reason: the time's coverage clause);
+//   - with k chosen, every open candidate is excluded (¬x_j ∨ ¬x_T); when
+//     only k are not excluded, every open one is forced (x_j ∨ x_F);
+//   - with k-2 multiples of q chosen, the open multiples are excluded;
+//   - disjoint packing: uncovered times that no open candidate covers two
+//     of need one new candidate each, taken greedily by fewest coverers. If
+//     there are more of them than open slots, that is a conflict. It is
+//     explained by k - |P| + 1 chosen candidates and the excluded
+//     candidates that would have covered two packed times.
+// Reasons are built only when the solver asks for them. An implication
+// records its rule, and its clause is read off the propagator's trail up to
+// the implied candidate, since that prefix stays in place while the
+// literal is assigned.
+
+#pragma once
+
+#include "lonely_common.hpp"
+#include "cdcl_solver.hpp"
+
+class CoverPropagator : public ExternalPropagator {
+public:
+    long long implied = 0;
+    long long coverageConflicts = 0, countConflicts = 0, packingConflicts = 0;
+
+    CoverPropagator(const vector<int>& xVars, const vector<int>& candidates, const vector<bitset<maxM>>& nearZero,
+                    const vector<int>& essentialTimes, const vector<int>& primeDivisors)
+        : numCand((int)candidates.size()), numTimes((int)essentialTimes.size()),
+          candWords(((int)candidates.size() + 63) / 64), xVars(xVars), limit(max(0, k - 2)) {
+        int maxVar = 0;
+        for (int x : xVars) maxVar = max(maxVar, x);
+        candOf.assign(maxVar + 1, -1);
+        for (int j = 0; j < numCand; ++j) candOf[xVars[j]] = j;
+
+        coverList.assign(numCand, {});
+        coverers.assign(numTimes, {});
+        coverOf.assign(numTimes, vector<uint64_t>(candWords, 0));
+        for (int t = 0; t < numTimes; ++t) {
+            for (int j = 0; j < numCand; ++j) {
+                if (!nearZero[candidates[j]][essentialTimes[t]]) continue;
+                coverList[j].push_back(t);
+                coverers[t].push_back(j);
+                coverOf[t][j >> 6] |= 1ULL << (j & 63);
+            }
+        }
+        multiples.assign(primeDivisors.size(), {});
+        sig.assign(numCand, 0);
+        for (int j = 0; j < numCand; ++j) {
+            for (int d = 0; d < (int)primeDivisors.size(); ++d) {
+                if (candidates[j] % primeDivisors[d] != 0) continue;
+                sig[j] |= 1u << d;
+                multiples[d].push_back(j);
+            }
+        }
+
+        val.assign(numCand, 0);
+        posOf.assign(numCand, -1);
+        ruleOf.assign(numCand, { RuleCover, 0 });
+        covered.assign(numTimes, 0);
+        open.resize(numTimes);
+        for (int t = 0; t < numTimes; ++t) open[t] = (int)coverers[t].size();
+        classCount.assign(primeDivisors.size(), 0);
+        inTight.assign(numTimes, 1);
+        for (int t = 0; t < numTimes; ++t) tight.push_back(t);
+        numOpen = numCand;
+    }
+
+    void notifyAssignment(const vector<int>& lits) override {
+        for (int lit : lits) {
+            int j = candOf[abs(lit)];
+            if (j < 0) continue;
+            assign(j, lit > 0 ? 1 : -1);
+        }
+    }
+
+    void notifyNewDecisionLevel() override { marks.push_back(trail.size()); }
+
+    void notifyBacktrack(int newLevel) override {
+        if (newLevel < (int)marks.size()) {
+            while (trail.size() > marks[newLevel]) {
+                unassign(trail.back());
+                trail.pop_back();
+            }
+            marks.resize(newLevel);
+        }
+        pending.clear();
+        pendingHead = 0;
+        conflicts.clear();
+        for (int t : tight) inTight[t] = 0;
+        tight.clear();
+        changed = true;
+    }
+
+    int propagate() override {
+        if (pendingHead == pending.size()) {
+            pending.clear();
+            pendingHead = 0;
+            if (changed) {
+                changed = false;
+                scan();
+            }
+        }
+        while (pendingHead < pending.size()) {
+            auto [lit, rule] = pending[pendingHead++];
+            int j = candOf[abs(lit)];
+            int want = lit > 0 ? 1 : -1;
+            if (val[j] == want) continue;
+            if (val[j] == -want) {
+                // Set the other way since the scan: the reason is a conflict
+                conflicts.push_back(explain(lit, rule, posOf[j]));
+                return 0;
+            }
+            ruleOf[j] = rule;
+            ++implied;
+            return lit;
+        }
+        return 0;
+    }
+
+    vector<int> reason(int lit) override {
+        int j = candOf[abs(lit)];
+        return explain(lit, ruleOf[j], posOf[j] >= 0 ? (size_t)posOf[j] : trail.size());
+    }
+
+    bool externalClause(vector<int>& clause) override {
+        if (conflicts.empty()) return false;
+        clause = move(conflicts.back());
+        conflicts.pop_back();
+        return true;
+    }
+
+    bool checkModel(const vector<int>& model) override {
+        vector<int> chosen;
+        for (int j = 0; j < numCand; ++j) {
+            if (model[xVars[j] - 1] > 0) chosen.push_back(j);
+        }
+        vector<int> count(numTimes, 0), perClass(multiples.size(), 0);
+        for (int j : chosen) {
+            for (int t : coverList[j]) ++count[t];
+            for (int d = 0; d < (int)multiples.size(); ++d) perClass[d] += sig[j] >> d & 1;
+        }
+        for (int t = 0; t < numTimes; ++t) {
+            if (count[t]) continue;
+            conflicts.push_back(coverageClause(t));
+            return false;
+        }
+        auto none = [&](const vector<int>& js) {
+            vector<int> c;
+            for (int j : js) c.push_back(-xVars[j]);
+            return c;
+        };
+        if ((int)chosen.size() > k) {
+            chosen.resize(k + 1);
+            conflicts.push_back(none(chosen));
+            return false;
+        }
+        if ((int)chosen.size() < k) {
+            vector<int> c;
+            for (int j = 0; j < numCand; ++j) {
+                if (model[xVars[j] - 1] < 0) c.push_back(xVars[j]);
+            }
+            conflicts.push_back(c);
+            return false;
+        }
+        for (int d = 0; d < (int)multiples.size(); ++d) {
+            if (perClass[d] <= limit) continue;
+            vector<int> c;
+            for (int j : chosen) {
+                if ((sig[j] >> d & 1) && (int)c.size() <= limit) c.push_back(-xVars[j]);
+            }
+            conflicts.push_back(c);
+            return false;
+        }
+        return true;
+    }
+
+private:
+    int numCand, numTimes, candWords;
+    vector<int> xVars, candOf;
+    int limit;
+    vector<vector<int>> coverList;      // coverList[j]: local times covered by j
+    vector<vector<int>> coverers;       // coverers[t]: candidates covering t
+    vector<vector<uint64_t>> coverOf;   // coverOf[t]: coverers as a bit row
+    vector<vector<int>> multiples;      // multiples[d]: candidates divisible by q_d
+    vector<uint32_t> sig;
+
+    vector<int8_t> val;                 // 1 chosen, -1 excluded, 0 open
+    vector<int> covered, open;          // per time: chosen and non-excluded coverers
+    vector<int> classCount;
+    int numTrue = 0, numOpen = 0;
+    vector<int> trail;                  // candidates in assignment order
+    vector<size_t> marks;               // trail size at each decision level
+    vector<int> tight;                  // times whose open count fell to 0 or 1
+    vector<char> inTight;
+    bool changed = true;
+
+    enum RuleKind { RuleCover, RuleAtMost, RuleAtLeast, RuleGcd };
+    struct Rule {
+        RuleKind kind;
+        int arg;                        // time (cover) or divisor index (gcd)
+    };
+    vector<pair<int, Rule>> pending;    // implied literal and its rule
+    size_t pendingHead = 0;
+    vector<Rule> ruleOf;                // per candidate: rule of its last implication
+    vector<int> posOf;                  // per candidate: trail position, -1 if open
+    vector<vector<int>> conflicts;
+
+    void assign(int j, int v) {
+        val[j] = (int8_t)v;
+        posOf[j] = (int)trail.size();
+        trail.push_back(j);
+        --numOpen;
+        changed = true;
+        if (v > 0) {
+            ++numTrue;
+            for (uint32_t m = sig[j]; m; m &= m - 1) ++classCount[__builtin_ctz(m)];
+            for (int t : coverList[j]) ++covered[t];
+            return;
+        }
+        for (int t : coverList[j]) {
+            if (--open[t] <= 1 && !inTight[t]) {
+                inTight[t] = 1;
+                tight.push_back(t);
+            }
+        }
+    }
+
+    void unassign(int j) {
+        if (val[j] > 0) {
+            --numTrue;
+            for (uint32_t m = sig[j]; m; m &= m - 1) --classCount[__builtin_ctz(m)];
+            for (int t : coverList[j]) --covered[t];
+        } else {
+            for (int t : coverList[j]) ++open[t];
+        }
+        val[j] = 0;
+        posOf[j] = -1;
+        ++numOpen;
+    }
+
+    vector<int> coverageClause(int t) const {
+        vector<int> c;
+        for (int j : coverers[t]) c.push_back(xVars[j]);
+        return c;
+    }
+
+    // Negations of the first `count` chosen candidates (in mask's classes)
+    // among trail[0, end), in trail order: lowest levels first
+    vector<int> chosenPrefix(int count, uint32_t mask = 0, size_t end = SIZE_MAX) const {
+        vector<int> c;
+        for (size_t i = 0; i < min(end, trail.size()); ++i) {
+            int j = trail[i];
+            if ((int)c.size() == count) break;
+            if (val[j] > 0 && (!mask || (sig[j] & mask))) c.push_back(-xVars[j]);
+        }
+        return c;
+    }
+
+    // Clause for lit under rule, from the trail prefix [0, end) that held
+    // when the rule fired
+    vector<int> explain(int lit, Rule r, size_t end) const {
+        if (r.kind == RuleCover) return coverageClause(r.arg);
+        vector<int> c;
+        if (r.kind == RuleAtMost) c = chosenPrefix(k, 0, end);
+        if (r.kind == RuleGcd) c = chosenPrefix(limit, 1u << r.arg, end);
+        if (r.kind == RuleAtLeast) {
+            for (size_t i = 0; i < end; ++i) {
+                if (val[trail[i]] < 0) c.push_back(xVars[trail[i]]);
+            }
+        }
+        c.insert(c.begin(), lit);
+        return c;
+    }
+
+    // Implications and conflicts of the current assignment
+    void scan() {
+        // Exactly k
+        if (numTrue > k) {
+            ++countConflicts;
+            conflicts.push_back(chosenPrefix(k + 1));
+            return;
+        }
+        if (numTrue + numOpen < k) {
+            vector<int> clause;
+            for (int j : trail) {
+                if (val[j] < 0) clause.push_back(xVars[j]);
+            }
+            ++countConflicts;
+            conflicts.push_back(clause);
+            return;
+        }
+        if (numOpen > 0 && (numTrue == k || numTrue + numOpen == k)) {
+            Rule rule = { numTrue == k ? RuleAtMost : RuleAtLeast, 0 };
+            for (int j = 0; j < numCand; ++j) {
+                if (val[j] == 0) pending.push_back({ numTrue == k ? -xVars[j] : xVars[j], rule });
+            }
+            return;
+        }
+
+        // GCD limits
+        for (int d = 0; d < (int)multiples.size(); ++d) {
+            if (classCount[d] > limit) {
+                ++countConflicts;
+                conflicts.push_back(chosenPrefix(limit + 1, 1u << d));
+                return;
+            }
+            if (classCount[d] < limit) continue;
+            for (int j : multiples[d]) {
+                if (val[j] == 0) pending.push_back({ -xVars[j], { RuleGcd, d } });
+            }
+        }
+
+        // Coverage of the times that ran low
+        for (int t : tight) {
+            inTight[t] = 0;
+            if (covered[t] > 0 || open[t] > 1) continue;
+            if (open[t] == 0) {
+                ++coverageConflicts;
+                conflicts.push_back(coverageClause(t));
+                for (int u : tight) inTight[u] = 0;
+                tight.clear();
+                pending.clear();
+                return;
+            }
+            for (int j : coverers[t]) {
+                if (val[j] == 0) {
+                    pending.push_back({ xVars[j], { RuleCover, t } });
+                    break;
+                }
+            }
+        }
+        tight.clear();
+        if (!pending.empty()) return;
+
+        packingBound();
+    }
+
+    // Greedy disjoint packing of the uncovered times against the open slots
+    void packingBound() {
+        vector<int> uncovered;
+        for (int t = 0; t < numTimes; ++t) {
+            if (covered[t] == 0) uncovered.push_back(t);
+        }
+        int slots = k - numTrue;
+        if ((int)uncovered.size() <= slots) return;
+        stable_sort(uncovered.begin(), uncovered.end(), [&](int a, int b) { return open[a] < open[b]; });
+
+        vector<uint64_t> availableRow(candWords, 0), blocked(candWords, 0);
+        for (int j = 0; j < numCand; ++j) {
+            if (val[j] >= 0) availableRow[j >> 6] |= 1ULL << (j & 63);
+        }
+        vector<int> packed;
+        for (int t : uncovered) {
+            bool disjoint = true;
+            for (int w = 0; w < candWords && disjoint; ++w) disjoint = !(coverOf[t][w] & availableRow[w] & blocked[w]);
+            if (!disjoint) continue;
+            packed.push_back(t);
+            for (int w = 0; w < candWords; ++w) blocked[w] |= coverOf[t][w] & availableRow[w];
+        }
+        if ((int)packed.size() <= slots) return;
+
+        ++packingConflicts;
+        // A larger packing needs fewer chosen candidates in the explanation
+        vector<int> clause = chosenPrefix(max(0, k - (int)packed.size() + 1));
+        vector<int> hits(numCand, 0);
+        for (int t : packed) {
+            for (int j : coverers[t]) {
+                if (val[j] < 0 && ++hits[j] == 2) clause.push_back(xVars[j]);
+            }
+        }
+        conflicts.push_back(clause);
+    }
+};
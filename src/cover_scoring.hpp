@@ -0,0 +1,92 @@
+// Batched scoring of all candidates against the uncovered set
+//
+// score(j) = |cover(j) ∩ U| for every candidate j in one pass over U. The
+// input is time-major (coverOf[t] is a bit row over candidates); each
+// uncovered time adds its row into bit-sliced vertical counters, so plane b
+// holds bit b of every candidate's count and one SIMD add covers 256 or 512
+// candidates at once. The carry ripples up only as far as it is non-zero.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+#include "uncovered_set.hpp"
+using namespace std;
+
+// Words per candidate row, padded so SIMD loads never need a tail
+constexpr int kScoreLaneWords = 8;
+
+inline int paddedWords(int nbits) {
+    int w = (nbits + 63) / 64;
+    return (w + kScoreLaneWords - 1) / kScoreLaneWords * kScoreLaneWords;
+}
+
+class CoverScorer {
+public:
+    CoverScorer() = default;
+
+    CoverScorer(int numCand, int maxCount)
+        : stride(paddedWords(numCand)) {
+        while ((1 << maxPlanes) <= maxCount) ++maxPlanes;
+        planes.assign((size_t)maxPlanes * stride, 0);
+    }
+
+    int strideWords() const { return stride; }
+
+    // Accumulate coverOf[t] for every t in U; rows must be strideWords() long
+    void score(const UncoveredSet& U, const vector<vector<uint64_t>>& coverOf) {
+        fill(planes.begin(), planes.end(), 0);
+        U.forEach([&](int t) { add(coverOf[t].data()); });
+    }
+
+    int count(int j) const {
+        int w = j >> 6, s = j & 63, c = 0;
+        for (int b = 0; b < maxPlanes; ++b) c |= (int)(planes[(size_t)b * stride + w] >> s & 1) << b;
+        return c;
+    }
+
+    // Add one row (0/1 per candidate) to the vertical counters
+    void add(const uint64_t* row) {
+#if defined(__AVX512F__)
+        for (int w = 0; w < stride; w += 8) {
+            __m512i carry = _mm512_loadu_si512((const void*)(row + w));
+            for (int b = 0; b < maxPlanes; ++b) {
+                uint64_t* p = &planes[(size_t)b * stride + w];
+                __m512i x = _mm512_loadu_si512((const void*)p);
+                _mm512_storeu_si512((void*)p, _mm512_xor_si512(x, carry));
+                carry = _mm512_and_si512(x, carry);
+                if (_mm512_test_epi64_mask(carry, carry) == 0) break;
+            }
+        }
+#elif defined(__AVX2__)
+        for (int w = 0; w < stride; w += 4) {
+            __m256i carry = _mm256_loadu_si256((const __m256i*)(row + w));
+            for (int b = 0; b < maxPlanes; ++b) {
+                __m256i* p = (__m256i*)&planes[(size_t)b * stride + w];
+                __m256i x = _mm256_loadu_si256(p);
+                _mm256_storeu_si256(p, _mm256_xor_si256(x, carry));
+                carry = _mm256_and_si256(x, carry);
+                if (_mm256_testz_si256(carry, carry)) break;
+            }
+        }
+#else
+        for (int w = 0; w < stride; ++w) {
+            uint64_t carry = row[w];
+            for (int b = 0; carry && b < maxPlanes; ++b) {
+                uint64_t& p = planes[(size_t)b * stride + w];
+                uint64_t x = p;
+                p = x ^ carry;
+                carry = x & carry;
+            }
+        }
+#endif
+    }
+
+private:
+    int stride = 0;
+    int maxPlanes = 1;
+    vector<uint64_t> planes;   // planes[b * stride + w]
+};
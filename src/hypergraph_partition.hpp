@@ -0,0 +1,443 @@
+// Multilevel hypergraph partitioning of the candidate–time incidence
+//
+// Vertices are the open times and every candidate is a net over the times it
+// covers. A k-way partition of the times comes from recursive bisection. Each
+// bisection is multilevel:
+//   - coarsen by heavy-net matching (pairs that share many small nets);
+//   - take the best of several greedily grown bisections of the coarsest
+//     level;
+//   - project back level by level, with Fiduccia–Mattheyses passes under a
+//     balance bound at every level.
+// The cut nets are the separator: candidates covering times of two parts.
+// Once the separator variables are fixed (chosen or excluded), every other
+// candidate covers times of one part only, so the residual splits into parts
+// that are coupled only through the global budgets (exactly k and the GCD
+// limits). No time is removed with the separator, so the balance bound on
+// the times holds for the parts as they are.
+//
+// On the full instance each candidate covers about 2/n of the times and
+// every net is cut. The partitioner therefore works on residual instances:
+// the top branching literals are fixed first (see decomposeResidual).
+
+#pragma once
+
+#include <array>
+#include <climits>
+#include <cmath>
+#include <numeric>
+#include <queue>
+#include <random>
+#include "lonely_common.hpp"
+
+struct Hypergraph {
+    int numVertices = 0;
+    vector<int> vertexWeight;
+    vector<vector<int>> nets;       // members, sorted
+    vector<int> netWeight;
+    vector<vector<int>> netsOf;     // incident nets per vertex
+
+    void index() {
+        netsOf.assign(numVertices, {});
+        for (int e = 0; e < (int)nets.size(); ++e) {
+            for (int v : nets[e]) netsOf[v].push_back(e);
+        }
+    }
+};
+
+// Vertex per open time; net per candidate (by index, selected by `live`)
+// over the open times it covers. netOf maps nets back to candidates; a
+// candidate covering a single time has no net, since it cannot be cut.
+Hypergraph buildTimeHypergraph(const vector<int>& candidates, const vector<bitset<maxM>>& nearZero,
+                               const vector<int>& openTimes, const vector<char>& live, vector<int>& netOf) {
+    Hypergraph h;
+    h.numVertices = (int)openTimes.size();
+    h.vertexWeight.assign(h.numVertices, 1);
+    netOf.clear();
+    for (int j = 0; j < (int)candidates.size(); ++j) {
+        if (!live[j]) continue;
+        vector<int> net;
+        for (int i = 0; i < h.numVertices; ++i) {
+            if (nearZero[candidates[j]][openTimes[i]]) net.push_back(i);
+        }
+        if (net.size() < 2) continue;
+        h.nets.push_back(net);
+        h.netWeight.push_back(1);
+        netOf.push_back(j);
+    }
+    h.index();
+    return h;
+}
+
+struct Decomposition {
+    int parts = 0;
+    vector<int> fixed;              // candidates fixed in before partitioning
+    vector<int> openTimes;          // essential times the fixed ones leave open
+    vector<int> part;               // per candidate; -1 separator, -2 covers no open time
+    vector<int> separator;          // sorted by open times covered, most first
+    vector<int> partSize;           // candidates per part, separator excluded
+    vector<int> partTimes;          // open times per part
+    int live = 0;                   // candidates covering an open time
+
+    // At least two parts keep candidates, and the separator is at most half
+    // of the live candidates: a larger one costs more cubes than it saves
+    bool decomposes() const {
+        int used = (int)count_if(partSize.begin(), partSize.end(), [](int s) { return s > 0; });
+        return used >= 2 && 2 * (int)separator.size() <= live;
+    }
+};
+
+namespace hypergraph_detail {
+
+// Contract the matching; sub[v] is v's coarse vertex. Single-vertex nets are
+// dropped and parallel nets merged.
+inline Hypergraph contract(const Hypergraph& h, const vector<int>& sub, int coarseCount) {
+    Hypergraph c;
+    c.numVertices = coarseCount;
+    c.vertexWeight.assign(coarseCount, 0);
+    for (int v = 0; v < h.numVertices; ++v) c.vertexWeight[sub[v]] += h.vertexWeight[v];
+    map<vector<int>, int> seen;
+    for (int e = 0; e < (int)h.nets.size(); ++e) {
+        vector<int> net;
+        for (int v : h.nets[e]) net.push_back(sub[v]);
+        sort(net.begin(), net.end());
+        net.erase(unique(net.begin(), net.end()), net.end());
+        if (net.size() < 2) continue;
+        auto it = seen.find(net);
+        if (it != seen.end()) {
+            c.netWeight[it->second] += h.netWeight[e];
+            continue;
+        }
+        seen.emplace(net, (int)c.nets.size());
+        c.nets.push_back(move(net));
+        c.netWeight.push_back(h.netWeight[e]);
+    }
+    c.index();
+    return c;
+}
+
+// Heavy-net matching: each vertex pairs with the unmatched neighbour that
+// maximises Σ w(e)/(|e|-1) over shared nets, within the weight cap
+inline vector<int> matchVertices(const Hypergraph& h, int weightCap, mt19937& rng, int& coarseCount) {
+    vector<int> order(h.numVertices);
+    iota(order.begin(), order.end(), 0);
+    shuffle(order.begin(), order.end(), rng);
+    vector<int> sub(h.numVertices, -1);
+    vector<double> score(h.numVertices, 0);
+    vector<int> touched;
+    coarseCount = 0;
+    for (int u : order) {
+        if (sub[u] >= 0) continue;
+        for (int e : h.netsOf[u]) {
+            double w = (double)h.netWeight[e] / (h.nets[e].size() - 1);
+            for (int v : h.nets[e]) {
+                if (v == u || sub[v] >= 0 || h.vertexWeight[u] + h.vertexWeight[v] > weightCap) continue;
+                if (score[v] == 0) touched.push_back(v);
+                score[v] += w;
+            }
+        }
+        int best = -1;
+        for (int v : touched) {
+            if (best < 0 || score[v] > score[best]) best = v;
+            score[v] = 0;
+        }
+        touched.clear();
+        sub[u] = coarseCount;
+        if (best >= 0) sub[best] = coarseCount;
+        ++coarseCount;
+    }
+    return sub;
+}
+
+inline int cutWeight(const Hypergraph& h, const vector<int>& side) {
+    int cut = 0;
+    for (int e = 0; e < (int)h.nets.size(); ++e) {
+        for (int v : h.nets[e]) {
+            if (side[v] != side[h.nets[e][0]]) {
+                cut += h.netWeight[e];
+                break;
+            }
+        }
+    }
+    return cut;
+}
+
+// Fiduccia–Mattheyses: each pass moves every vertex once, highest gain first
+// (moves that break balance are skipped), then rolls back to the best prefix
+inline void refine(const Hypergraph& h, vector<int>& side, int maxSide, int passes = 8) {
+    vector<array<int, 2>> count(h.nets.size(), { 0, 0 });
+    array<int, 2> weight = { 0, 0 };
+    for (int v = 0; v < h.numVertices; ++v) weight[side[v]] += h.vertexWeight[v];
+
+    for (int pass = 0; pass < passes; ++pass) {
+        for (auto& c : count) c = { 0, 0 };
+        for (int e = 0; e < (int)h.nets.size(); ++e) {
+            for (int v : h.nets[e]) ++count[e][side[v]];
+        }
+        auto gainOf = [&](int v) {
+            int from = side[v], g = 0;
+            for (int e : h.netsOf[v]) {
+                if (count[e][from] == 1) g += h.netWeight[e];
+                if (count[e][1 - from] == 0) g -= h.netWeight[e];
+            }
+            return g;
+        };
+
+        // Lazy max-heap of (gain, vertex); stale entries are skipped
+        priority_queue<pair<int, int>> heap;
+        vector<int> gain(h.numVertices);
+        vector<char> locked(h.numVertices, 0), stamp(h.numVertices, 0);
+        vector<int> changed;
+        for (int v = 0; v < h.numVertices; ++v) {
+            gain[v] = gainOf(v);
+            heap.push({ gain[v], v });
+        }
+
+        vector<int> moved;
+        int running = 0, best = 0, bestPrefix = 0;
+        while (!heap.empty()) {
+            auto [g, v] = heap.top();
+            heap.pop();
+            if (locked[v] || g != gain[v]) continue;
+            int from = side[v], to = 1 - from;
+            if (weight[to] + h.vertexWeight[v] > maxSide) continue;
+            locked[v] = 1;
+            side[v] = to;
+            weight[from] -= h.vertexWeight[v];
+            weight[to] += h.vertexWeight[v];
+            // Standard FM gain deltas, from the counts before and after
+            for (int e : h.netsOf[v]) {
+                int w = h.netWeight[e];
+                if (count[e][to] == 0 || count[e][to] == 1 || count[e][from] == 1 || count[e][from] == 2) {
+                    for (int u : h.nets[e]) {
+                        if (locked[u]) continue;
+                        int d = 0;
+                        if (count[e][to] == 0) d += w;
+                        if (count[e][to] == 1 && side[u] == to) d -= w;
+                        if (count[e][from] == 1) d -= w;
+                        if (count[e][from] == 2 && side[u] == from) d += w;
+                        if (d) {
+                            gain[u] += d;
+                            if (!stamp[u]) changed.push_back(u);
+                            stamp[u] = 1;
+                        }
+                    }
+                }
+                --count[e][from];
+                ++count[e][to];
+            }
+            for (int u : changed) {
+                heap.push({ gain[u], u });
+                stamp[u] = 0;
+            }
+            changed.clear();
+            running += g;
+            moved.push_back(v);
+            if (running > best) {
+                best = running;
+                bestPrefix = (int)moved.size();
+            }
+        }
+        for (int i = (int)moved.size() - 1; i >= bestPrefix; --i) {
+            int v = moved[i];
+            weight[side[v]] -= h.vertexWeight[v];
+            side[v] = 1 - side[v];
+            weight[side[v]] += h.vertexWeight[v];
+        }
+        if (best == 0) break;
+    }
+}
+
+// Grow side 1 from a random seed, always adding the frontier vertex that
+// shares the most net weight with it, until it holds half the weight
+inline vector<int> growBisection(const Hypergraph& h, mt19937& rng) {
+    int total = 0;
+    for (int w : h.vertexWeight) total += w;
+    vector<int> side(h.numVertices, 0);
+    vector<double> pull(h.numVertices, 0);
+    int grown = 0;
+    int seed = uniform_int_distribution<int>(0, h.numVertices - 1)(rng);
+    while (2 * grown < total) {
+        int v = seed;
+        if (grown > 0) {
+            v = -1;
+            for (int u = 0; u < h.numVertices; ++u) {
+                if (side[u] == 0 && (v < 0 || pull[u] > pull[v])) v = u;
+            }
+        }
+        side[v] = 1;
+        grown += h.vertexWeight[v];
+        for (int e : h.netsOf[v]) {
+            for (int u : h.nets[e]) pull[u] += (double)h.netWeight[e] / h.nets[e].size();
+        }
+    }
+    return side;
+}
+
+// Multilevel bisection; side[v] in {0, 1}
+inline vector<int> bisect(const Hypergraph& h, double imbalance, mt19937& rng) {
+    int total = 0;
+    for (int w : h.vertexWeight) total += w;
+    int maxSide = (int)ceil((1 + imbalance) * total / 2);
+    if (h.numVertices < 2) return vector<int>(h.numVertices, 0);
+
+    // Coarsen until small or matching stalls
+    vector<Hypergraph> levels = { h };
+    vector<vector<int>> maps;
+    while (levels.back().numVertices > 64) {
+        int coarseCount;
+        vector<int> sub = matchVertices(levels.back(), max(2, total / 32), rng, coarseCount);
+        if (coarseCount > 0.9 * levels.back().numVertices) break;
+        maps.push_back(sub);
+        levels.push_back(contract(levels.back(), sub, coarseCount));
+    }
+
+    // Initial bisections of the coarsest level
+    const Hypergraph& coarsest = levels.back();
+    vector<int> side;
+    int bestCut = INT_MAX;
+    for (int attempt = 0; attempt < 8; ++attempt) {
+        vector<int> trial = growBisection(coarsest, rng);
+        refine(coarsest, trial, maxSide);
+        int cut = cutWeight(coarsest, trial);
+        if (cut < bestCut) {
+            bestCut = cut;
+            side = trial;
+        }
+    }
+
+    // Project and refine
+    for (int level = (int)maps.size() - 1; level >= 0; --level) {
+        vector<int> finer(levels[level].numVertices);
+        for (int v = 0; v < levels[level].numVertices; ++v) finer[v] = side[maps[level][v]];
+        side = move(finer);
+        refine(levels[level], side, maxSide);
+    }
+    return side;
+}
+
+// Vertices of h restricted to `keep`; sub-net members renumbered
+inline Hypergraph induce(const Hypergraph& h, const vector<int>& keep) {
+    vector<int> local(h.numVertices, -1);
+    for (int i = 0; i < (int)keep.size(); ++i) local[keep[i]] = i;
+    Hypergraph s;
+    s.numVertices = (int)keep.size();
+    for (int v : keep) s.vertexWeight.push_back(h.vertexWeight[v]);
+    for (int e = 0; e < (int)h.nets.size(); ++e) {
+        vector<int> net;
+        for (int v : h.nets[e]) {
+            if (local[v] >= 0) net.push_back(local[v]);
+        }
+        if (net.size() < 2) continue;
+        s.nets.push_back(net);
+        s.netWeight.push_back(h.netWeight[e]);
+    }
+    s.index();
+    return s;
+}
+
+}  // namespace hypergraph_detail
+
+// parts-way partition of the open times by recursive bisection; the
+// candidates whose times span two parts form the separator. imbalance
+// bounds each side of a bisection at (1 + ε)/2 of its times.
+Decomposition decomposeTimes(const vector<int>& candidates, const vector<bitset<maxM>>& nearZero,
+                             const vector<int>& openTimes, const vector<char>& live, int parts,
+                             double imbalance = 0.1, unsigned seed = 12345) {
+    using namespace hypergraph_detail;
+    mt19937 rng(seed);
+    vector<int> netOf;
+    Hypergraph h = buildTimeHypergraph(candidates, nearZero, openTimes, live, netOf);
+    vector<vector<int>> pending = { vector<int>(h.numVertices) };
+    iota(pending[0].begin(), pending[0].end(), 0);
+    vector<vector<int>> done;
+    // Split the largest part until there are enough
+    while ((int)(pending.size() + done.size()) < parts && !pending.empty()) {
+        auto largest = max_element(pending.begin(), pending.end(),
+                                   [](const auto& a, const auto& b) { return a.size() < b.size(); });
+        vector<int> vertices = move(*largest);
+        pending.erase(largest);
+        if (vertices.size() < 2) {
+            done.push_back(vertices);
+            continue;
+        }
+        vector<int> side = bisect(induce(h, vertices), imbalance, rng);
+        vector<int> halves[2];
+        for (int i = 0; i < (int)vertices.size(); ++i) halves[side[i]].push_back(vertices[i]);
+        for (auto& half : halves) {
+            if (!half.empty()) pending.push_back(move(half));
+        }
+    }
+    for (auto& p : pending) done.push_back(move(p));
+
+    Decomposition d;
+    d.parts = (int)done.size();
+    d.openTimes = openTimes;
+    d.partTimes.assign(d.parts, 0);
+    vector<int> timePart(openTimes.size());
+    for (int p = 0; p < d.parts; ++p) {
+        for (int i : done[p]) timePart[i] = p;
+        d.partTimes[p] = (int)done[p].size();
+    }
+
+    // A candidate joins the part of its times, or the separator if they span two
+    d.part.assign(candidates.size(), -2);
+    d.partSize.assign(d.parts, 0);
+    vector<int> covered(candidates.size(), 0);
+    for (int j = 0; j < (int)candidates.size(); ++j) {
+        if (!live[j]) continue;
+        for (int i = 0; i < (int)openTimes.size(); ++i) {
+            if (!nearZero[candidates[j]][openTimes[i]]) continue;
+            ++covered[j];
+            int p = timePart[i];
+            d.part[j] = d.part[j] == -2 || d.part[j] == p ? p : -1;
+        }
+        if (d.part[j] == -2) continue;
+        ++d.live;
+        if (d.part[j] < 0) d.separator.push_back(j);
+        else ++d.partSize[d.part[j]];
+    }
+    stable_sort(d.separator.begin(), d.separator.end(), [&](int a, int b) { return covered[a] > covered[b]; });
+    return d;
+}
+
+// Decomposition of a residual instance. The top branching literals are
+// fixed in one at a time: the candidate covering the most open times, within
+// the GCD limits. After each one the open times are partitioned, up to k-1
+// fixed candidates. Returns the first residual that decomposes, else the
+// last one tried.
+Decomposition decomposeResidual(const vector<int>& candidates, const vector<bitset<maxM>>& nearZero,
+                                const vector<int>& essentialTimes, const vector<int>& primeDivisors,
+                                int parts) {
+    vector<char> live(candidates.size(), 1);
+    vector<int> openTimes = essentialTimes, fixed, classCount(primeDivisors.size(), 0);
+    Decomposition d;
+    for (;;) {
+        d = decomposeTimes(candidates, nearZero, openTimes, live, parts);
+        d.fixed = fixed;
+        if (d.decomposes() || (int)fixed.size() == k - 1 || openTimes.empty()) return d;
+
+        int best = -1, bestCovered = 0;
+        for (int j = 0; j < (int)candidates.size(); ++j) {
+            if (!live[j]) continue;
+            bool fits = true;
+            for (int q = 0; q < (int)primeDivisors.size(); ++q) {
+                fits &= candidates[j] % primeDivisors[q] != 0 || classCount[q] < max(0, k - 2);
+            }
+            int c = 0;
+            for (int t : openTimes) c += nearZero[candidates[j]][t];
+            if (fits && c > bestCovered) {
+                best = j;
+                bestCovered = c;
+            }
+        }
+        if (best < 0) return d;
+        live[best] = 0;
+        fixed.push_back(best);
+        for (int q = 0; q < (int)primeDivisors.size(); ++q) classCount[q] += candidates[best] % primeDivisors[q] == 0;
+        vector<int> stillOpen;
+        for (int t : openTimes) {
+            if (!nearZero[candidates[best]][t]) stillOpen.push_back(t);
+        }
+        openTimes = move(stillOpen);
+    }
+}
@@ -0,0 +1,110 @@
+// On-disk cache of learnt clauses for the in-tree CDCL solver
+//
+// A checkpoint keeps the learnt clauses with low LBD, plus the root-level
+// units. Every clause is implied by the formula, so a later run of the same
+// instance can load them as redundant clauses and skip the search that found
+// them. The file name and header carry a hash of the whole CNF, so auxiliary
+// (counter, slot) numbering cannot drift: a file for a different formula is
+// never read. Writes go through a temporary file and a rename, so a run
+// killed mid-write leaves the previous checkpoint intact.
+//
+// File: "c lonely-learnt k p hash", then DIMACS clauses ending in 0.
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+using namespace std;
+
+class LearntCache {
+public:
+    int maxLbd = 10;
+
+    LearntCache(const string& dir, int k, int prime, uint64_t hash, int maxVar, int workers)
+        : maxVar(maxVar), snapshots(workers) {
+        ostringstream name, tag;
+        name << dir << "/lonely_" << k << "_" << prime << "_" << hex << hash << ".learnt";
+        tag << "c lonely-learnt " << k << " " << prime << " " << hex << hash;
+        path = name.str();
+        header = tag.str();
+    }
+
+    const string& file() const { return path; }
+
+    // Clauses of an earlier checkpoint; empty if none or the header differs
+    vector<vector<int>> load() const {
+        vector<vector<int>> clauses;
+        ifstream in(path);
+        string line;
+        if (!getline(in, line) || line != header) return clauses;
+        while (getline(in, line)) {
+            istringstream words(line);
+            vector<int> clause;
+            int lit;
+            while (words >> lit && lit != 0) {
+                if (abs(lit) > maxVar) break;
+                clause.push_back(lit);
+            }
+            if (lit == 0 && !clause.empty()) clauses.push_back(move(clause));
+        }
+        return clauses;
+    }
+
+    // Latest clauses of one worker; the file is the union over workers
+    void store(int worker, vector<vector<int>> clauses) {
+        lock_guard<mutex> lock(m);
+        snapshots[worker] = move(clauses);
+        set<vector<int>> merged;
+        for (const auto& snapshot : snapshots) {
+            for (auto c : snapshot) {
+                sort(c.begin(), c.end());
+                merged.insert(move(c));
+            }
+        }
+        string temp = path + ".tmp";
+        {
+            ofstream out(temp);
+            out << header << "\n";
+            for (const auto& c : merged) {
+                for (int lit : c) out << lit << " ";
+                out << "0\n";
+            }
+            if (!out) return;
+        }
+        rename(temp.c_str(), path.c_str());
+        stored = merged.size();
+    }
+
+    size_t lastStored() const { return stored; }
+
+private:
+    string path, header;
+    int maxVar;
+    mutex m;
+    vector<vector<vector<int>>> snapshots;
+    size_t stored = 0;
+};
+
+// FNV-1a over the variable count and every clause, in order
+inline uint64_t hashFormula(int numVars, const vector<vector<int>>& clauses) {
+    uint64_t h = 0xcbf29ce484222325ULL;
+    auto mix = [&](int64_t x) {
+        for (int b = 0; b < 8; ++b) {
+            h ^= (uint64_t)(x >> (8 * b)) & 0xff;
+            h *= 0x100000001b3ULL;
+        }
+    };
+    mix(numVars);
+    for (const auto& c : clauses) {
+        for (int lit : c) mix(lit);
+        mix(0);
+    }
+    return h;
+}
@@ -0,0 +1,430 @@
+// Checker for symmetry-compressed native certificates
+// Reads a certificate written by `lonely_native_search --cert FILE` on stdin:
+//
+//   p lonely K PRIME
+//   D nd ne                nd velocity and ne time removals follow
+//   d v a                  velocity v removed, dominated by a
+//   e t s                  time t removed, implied by covering time s
+//   g u1 u2 ... 0          generators of the ±unit group action
+//   o r1 r2 ... 0          orbit representatives, in case order
+//   r r_i                  case i: r_i chosen, orbits before i excluded
+//   B t v1 ... vm          branch on uncovered time t, children in order
+//   P | K | E t | L | S    leaf: no padding / k used / t uncoverable /
+//                          last slot cannot cover / coverage-sum bound
+//   w v1 ... vk 0          covering (SAT)
+//
+// The reduced instance is derived from the unreduced one ([1..maxM] \ pZ,
+// all times) by replaying the d/e steps in order, each against the instance
+// as it stands: a covers every time v covers and is divisible by no q | n
+// that v is not; every remaining candidate covering s covers t. A covering
+// through v then maps to one through a, or pads with a velocity divisible
+// by no q when a is already in it (at least k such velocities must remain).
+// Without a D line the full dominance passes are recomputed and trusted.
+// A file that ends after the steps checks only the reduction (the
+// generator's --reductions log); no CNF built from it is checked.
+// The group action is checked directly (every generator is a unit mod Q
+// that maps the reduced candidates onto themselves, keeps divisibility by
+// each q | n, and preserves t·v mod Q through a time permutation). The case
+// split is then valid, and each case tree is replayed against the reduced
+// instance.
+//
+// David H. Silver, 2025
+
+#include "lonely_common.hpp"
+#include <sstream>
+#include <numeric>
+
+bool closeToZero(long long t, long long v) {
+    long long ti = (t * v) % Q;
+    return (ti * n < Q) || ((Q - ti) * n < Q);
+}
+
+int fold(long long x) {
+    int r = (int)(((x % Q) + Q) % Q);
+    return r > maxM ? Q - r : r;
+}
+
+struct Checker {
+    vector<int> candidates;
+    vector<int> times;                  // essential times, as t in [1..maxM]
+    vector<vector<char>> covers;        // covers[j][i]: candidate j covers times[i]
+    vector<uint32_t> sig;               // divisibility signature per candidate
+    vector<int> primeDivisors;
+    vector<int> indexOf;
+    int limit = max(0, k - 2);
+
+    vector<char> uncovered;
+    int numUncovered = 0;
+    vector<char> excluded, chosen;
+    int numChosen = 0;
+    vector<int> classCount;
+
+    vector<vector<string>> lines;
+    size_t pos = 0;
+    long long nodesChecked = 0;
+    string error;
+
+    bool fail(const string& msg) {
+        if (error.empty()) error = "line " + to_string(pos) + ": " + msg;
+        return false;
+    }
+
+    bool fits(int j) const {
+        for (int d = 0; d < (int)primeDivisors.size(); ++d) {
+            if ((sig[j] >> d & 1) && classCount[d] >= limit) return false;
+        }
+        return true;
+    }
+
+    bool available(int j) const { return !excluded[j] && !chosen[j]; }
+
+    void choose(int j, vector<int>& newlyCovered) {
+        chosen[j] = 1;
+        ++numChosen;
+        for (int d = 0; d < (int)primeDivisors.size(); ++d) classCount[d] += sig[j] >> d & 1;
+        for (int i = 0; i < (int)times.size(); ++i) {
+            if (uncovered[i] && covers[j][i]) {
+                uncovered[i] = 0;
+                --numUncovered;
+                newlyCovered.push_back(i);
+            }
+        }
+    }
+
+    void unchoose(int j, const vector<int>& newlyCovered) {
+        for (int i : newlyCovered) uncovered[i] = 1;
+        numUncovered += (int)newlyCovered.size();
+        for (int d = 0; d < (int)primeDivisors.size(); ++d) classCount[d] -= sig[j] >> d & 1;
+        --numChosen;
+        chosen[j] = 0;
+    }
+
+    int timeIndex(const string& tok) const {
+        int t = stoi(tok);
+        auto it = find(times.begin(), times.end(), t);
+        return it == times.end() ? -1 : (int)(it - times.begin());
+    }
+
+    int candIndex(const string& tok) const {
+        int v = stoi(tok);
+        return v >= 1 && v <= maxM ? indexOf[v] : -1;
+    }
+
+    // Some (k - numChosen)-subset of the available candidates fits the GCD limits
+    bool paddingExists() const {
+        vector<int> bySig(1u << primeDivisors.size(), 0);
+        for (int j = 0; j < (int)candidates.size(); ++j) {
+            if (available(j)) ++bySig[sig[j]];
+        }
+        vector<int> budget(primeDivisors.size());
+        for (int d = 0; d < (int)budget.size(); ++d) budget[d] = limit - classCount[d];
+        function<bool(int, int)> rec = [&](int s, int left) {
+            if (s == (int)bySig.size()) return left == 0;
+            for (int c = 0; c <= min(left, bySig[s]); ++c) {
+                bool ok = true;
+                for (int d = 0; d < (int)budget.size(); ++d) {
+                    if (s >> d & 1) ok &= c <= budget[d];
+                }
+                if (!ok) break;
+                for (int d = 0; d < (int)budget.size(); ++d) if (s >> d & 1) budget[d] -= c;
+                bool found = rec(s + 1, left - c);
+                for (int d = 0; d < (int)budget.size(); ++d) if (s >> d & 1) budget[d] += c;
+                if (found) return true;
+            }
+            return false;
+        };
+        return rec(0, k - numChosen);
+    }
+
+    // Replay one subtree starting at lines[pos]
+    bool replay() {
+        if (pos >= lines.size()) return fail("truncated tree");
+        const auto& line = lines[pos++];
+        ++nodesChecked;
+        const string& tag = line[0];
+
+        if (tag == "P") {
+            if (numUncovered != 0) return fail("P with uncovered times");
+            if (paddingExists()) return fail("P but a padding exists");
+            return true;
+        }
+        if (tag == "K") {
+            if (numChosen != k || numUncovered == 0) return fail("K not justified");
+            return true;
+        }
+        if (tag == "E") {
+            int i = line.size() > 1 ? timeIndex(line[1]) : -1;
+            if (i < 0 || !uncovered[i]) return fail("E on a covered or unknown time");
+            for (int j = 0; j < (int)candidates.size(); ++j) {
+                if (available(j) && covers[j][i]) return fail("E but time is coverable");
+            }
+            return true;
+        }
+        if (tag == "L") {
+            if (numChosen != k - 1 || numUncovered == 0) return fail("L not at last slot");
+            for (int j = 0; j < (int)candidates.size(); ++j) {
+                if (!available(j) || !fits(j)) continue;
+                bool all = true;
+                for (int i = 0; i < (int)times.size() && all; ++i) all = !uncovered[i] || covers[j][i];
+                if (all) return fail("L but a candidate covers the rest");
+            }
+            return true;
+        }
+        if (tag == "S") {
+            vector<int> scores;
+            for (int j = 0; j < (int)candidates.size(); ++j) {
+                if (!available(j) || !fits(j)) continue;
+                int c = 0;
+                for (int i = 0; i < (int)times.size(); ++i) c += uncovered[i] && covers[j][i];
+                scores.push_back(c);
+            }
+            sort(scores.rbegin(), scores.rend());
+            long long reach = 0;
+            for (int i = 0; i < min((int)scores.size(), k - numChosen); ++i) reach += scores[i];
+            if (reach >= numUncovered) return fail("S bound does not hold");
+            return true;
+        }
+        if (tag != "B") return fail("unknown node " + tag);
+
+        int i = line.size() > 1 ? timeIndex(line[1]) : -1;
+        if (i < 0 || !uncovered[i]) return fail("B on a covered or unknown time");
+        if (numChosen >= k) return fail("B with no slot left");
+
+        vector<int> children;
+        vector<char> listed(candidates.size(), 0);
+        for (size_t c = 2; c < line.size(); ++c) {
+            int j = candIndex(line[c]);
+            if (j < 0 || listed[j]) return fail("bad or repeated child " + line[c]);
+            listed[j] = 1;
+            children.push_back(j);
+        }
+        for (int j = 0; j < (int)candidates.size(); ++j) {
+            bool expected = available(j) && fits(j) && covers[j][i];
+            if (expected != (bool)listed[j]) return fail("children do not match cover of t");
+        }
+
+        for (int j : children) {
+            vector<int> newlyCovered;
+            choose(j, newlyCovered);
+            bool ok = replay();
+            unchoose(j, newlyCovered);
+            if (!ok) return false;
+            excluded[j] = 1;
+        }
+        for (int j : children) excluded[j] = 0;
+        return true;
+    }
+};
+
+int main() {
+    ios::sync_with_stdio(false);
+
+    Checker ck;
+    string text;
+    while (getline(cin, text)) {
+        istringstream in(text);
+        vector<string> toks;
+        string tok;
+        while (in >> tok) toks.push_back(tok);
+        if (!toks.empty() && toks[0] != "c") ck.lines.push_back(toks);
+    }
+
+    auto reject = [&](const string& msg) {
+        cout << "s REJECTED\nc " << msg << "\n";
+        return 1;
+    };
+
+    if (ck.lines.size() < 2 || ck.lines[0].size() != 4 || ck.lines[0][0] != "p"
+        || stoi(ck.lines[0][2]) != k || stoi(ck.lines[0][3]) != prime) {
+        return reject("header does not match K=" + to_string(k) + " PRIME=" + to_string(prime));
+    }
+
+    // Reduced instance: replay the logged removals, or trust the full passes
+    vector<bitset<maxM>> nearZero = buildNearZero();
+    ck.primeDivisors = getPrimeDivisors(n);
+    size_t first = 1;
+    long long velocitySteps = 0, timeSteps = 0;
+    bool logged = ck.lines[first][0] == "D";
+    if (logged) {
+        if (ck.lines[first].size() != 3) return reject("malformed D line");
+        long long expectVelocities = stoll(ck.lines[first][1]), expectTimes = stoll(ck.lines[first][2]);
+        ++first;
+        vector<char> live(maxM + 1, 0), liveTime(maxM + 1, 1);
+        for (int v : initialCandidates()) live[v] = 1;
+        auto divisibleOnlyIf = [&](int a, int v) {
+            for (int q : ck.primeDivisors) {
+                if (a % q == 0 && v % q != 0) return false;
+            }
+            return true;
+        };
+        for (; first < ck.lines.size(); ++first) {
+            const auto& line = ck.lines[first];
+            if (line[0] != "d" && line[0] != "e") break;
+            if (line.size() != 3) return reject("line " + to_string(first) + ": malformed step");
+            int x = stoi(line[1]), y = stoi(line[2]);
+            if (x < 1 || x > maxM || y < 1 || y > maxM || x == y) {
+                return reject("line " + to_string(first) + ": step out of range");
+            }
+            if (line[0] == "d") {
+                if (!live[x] || !live[y]) return reject("d " + line[1] + " " + line[2] + ": velocity already removed");
+                if (!divisibleOnlyIf(y, x)) return reject("d " + line[1] + " " + line[2] + ": dominator adds a multiple");
+                for (int t = 1; t <= maxM; ++t) {
+                    if (closeToZero(t, x) && !closeToZero(t, y)) {
+                        return reject("d " + line[1] + " " + line[2] + ": dominator misses t=" + to_string(t));
+                    }
+                }
+                live[x] = 0;
+                ++velocitySteps;
+            } else {
+                if (!liveTime[x] || !liveTime[y]) return reject("e " + line[1] + " " + line[2] + ": time already removed");
+                for (int v = 1; v <= maxM; ++v) {
+                    if (live[v] && closeToZero(y, v) && !closeToZero(x, v)) {
+                        return reject("e " + line[1] + " " + line[2] + ": v=" + to_string(v) + " covers only s");
+                    }
+                }
+                liveTime[x] = 0;
+                ++timeSteps;
+            }
+        }
+        int plain = 0;
+        for (int v = 1; v <= maxM; ++v) {
+            if (!live[v]) continue;
+            ck.candidates.push_back(v);
+            plain += divisibleOnlyIf(v, 1);
+        }
+        if (velocitySteps != expectVelocities || timeSteps != expectTimes) {
+            return reject("D line announces " + to_string(expectVelocities) + "/" + to_string(expectTimes)
+                          + " steps, found " + to_string(velocitySteps) + "/" + to_string(timeSteps));
+        }
+        if (velocitySteps && plain < k) return reject("fewer than k velocities divisible by no q remain");
+        for (int t = maxM; t >= 1; --t) {
+            if (liveTime[t]) ck.times.push_back(t);
+        }
+    } else {
+        ck.candidates = reduceCandidatesByDominance(initialCandidates(), nearZero, ck.primeDivisors);
+        for (int b : reduceTimesByDominance(buildCoverageSets(ck.candidates, nearZero))) {
+            ck.times.push_back(maxM - b);
+        }
+    }
+    string reduction = logged
+        ? to_string(velocitySteps) + " velocity and " + to_string(timeSteps) + " time removals checked"
+        : "dominance recomputed (trusted)";
+    if (first == ck.lines.size()) {
+        cout << "s REDUCED\nc " << reduction << "; " << ck.candidates.size() << " candidates, "
+             << ck.times.size() << " times (reduction only)\n";
+        return 0;
+    }
+    if (ck.lines.size() < first + 2) return reject("missing generator or orbit line");
+
+    int numCand = (int)ck.candidates.size();
+    ck.indexOf.assign(maxM + 1, -1);
+    ck.sig.assign(numCand, 0);
+    ck.covers.assign(numCand, vector<char>(ck.times.size(), 0));
+    for (int j = 0; j < numCand; ++j) {
+        int v = ck.candidates[j];
+        ck.indexOf[v] = j;
+        for (int d = 0; d < (int)ck.primeDivisors.size(); ++d) {
+            if (v % ck.primeDivisors[d] == 0) ck.sig[j] |= 1u << d;
+        }
+        for (int i = 0; i < (int)ck.times.size(); ++i) ck.covers[j][i] = closeToZero(ck.times[i], v);
+    }
+
+    // Group action: units mapping candidates onto candidates, keeping the
+    // signature and every incidence ||t v / Q|| < 1/n
+    vector<int> gens;
+    const auto& genLine = ck.lines[first];
+    for (size_t i = 1; i < genLine.size(); ++i) {
+        int u = stoi(genLine[i]);
+        if (u != 0) gens.push_back(u);
+    }
+    if (genLine[0] != "g") return reject("missing generator line");
+    for (int u : gens) {
+        if (u < 1 || u > maxM || gcd(u, Q) != 1) return reject("generator " + to_string(u) + " is not a unit");
+        int uinv = 0;
+        for (int x = 1; x < Q && !uinv; ++x) if ((long long)u * x % Q == 1) uinv = x;
+        for (int j = 0; j < numCand; ++j) {
+            int v = ck.candidates[j];
+            int w = fold((long long)u * v);
+            if (ck.indexOf[w] < 0) return reject("generator " + to_string(u) + " leaves the candidates");
+            if (ck.sig[ck.indexOf[w]] != ck.sig[j]) return reject("generator " + to_string(u) + " changes a signature");
+            for (int t = 1; t <= maxM; ++t) {
+                if (closeToZero(t, v) != closeToZero(fold((long long)t * uinv), w)) {
+                    return reject("generator " + to_string(u) + " breaks coverage");
+                }
+            }
+        }
+    }
+
+    // Orbits by union-find; representatives must be the orbit minima
+    vector<int> parent(numCand);
+    iota(parent.begin(), parent.end(), 0);
+    function<int(int)> find = [&](int x) { return parent[x] == x ? x : parent[x] = find(parent[x]); };
+    for (int u : gens) {
+        for (int j = 0; j < numCand; ++j) {
+            parent[find(j)] = find(ck.indexOf[fold((long long)u * ck.candidates[j])]);
+        }
+    }
+    const auto& orbitLine = ck.lines[first + 1];
+    if (orbitLine[0] != "o") return reject("missing orbit line");
+    vector<int> reps;
+    vector<char> orbitSeen(numCand, 0);
+    for (size_t i = 1; i < orbitLine.size(); ++i) {
+        int v = stoi(orbitLine[i]);
+        if (v == 0) continue;
+        int j = v <= maxM ? ck.indexOf[v] : -1;
+        if (j < 0 || orbitSeen[find(j)]) return reject("bad orbit representative " + to_string(v));
+        for (int x = 0; x < j; ++x) {
+            if (find(x) == find(j)) return reject("representative " + to_string(v) + " is not the orbit minimum");
+        }
+        orbitSeen[find(j)] = 1;
+        reps.push_back(j);
+    }
+    for (int j = 0; j < numCand; ++j) {
+        if (!orbitSeen[find(j)]) return reject("orbit of " + to_string(ck.candidates[j]) + " has no case");
+    }
+
+    // Witness, if any
+    for (const auto& line : ck.lines) {
+        if (line[0] != "w") continue;
+        vector<int> S;
+        for (size_t i = 1; i < line.size(); ++i) if (line[i] != "0") S.push_back(stoi(line[i]));
+        sort(S.begin(), S.end());
+        if ((int)S.size() != k || adjacent_find(S.begin(), S.end()) != S.end()) return reject("witness is not a k-set");
+        for (int v : S) if (v < 1 || v > maxM || v % prime == 0) return reject("witness velocity out of range");
+        for (int q : ck.primeDivisors) {
+            if (count_if(S.begin(), S.end(), [&](int v) { return v % q == 0; }) > ck.limit) return reject("witness breaks GCD limit");
+        }
+        for (int t = 1; t <= maxM; ++t) {
+            if (none_of(S.begin(), S.end(), [&](int v) { return closeToZero(t, v); })) return reject("witness misses t=" + to_string(t));
+        }
+        cout << "s SATISFIABLE\nc witness verified; " << reduction << "\n";
+        return 0;
+    }
+
+    // Case i: reps[i] chosen, orbits of reps[0..i-1] excluded
+    ck.uncovered.assign(ck.times.size(), 1);
+    ck.numUncovered = (int)ck.times.size();
+    ck.excluded.assign(numCand, 0);
+    ck.chosen.assign(numCand, 0);
+    ck.classCount.assign(ck.primeDivisors.size(), 0);
+    ck.pos = first + 2;
+    for (int r : reps) {
+        if (ck.pos >= ck.lines.size() || ck.lines[ck.pos].size() != 2 || ck.lines[ck.pos][0] != "r"
+            || ck.candIndex(ck.lines[ck.pos][1]) != r) {
+            return reject("missing case for " + to_string(ck.candidates[r]));
+        }
+        ++ck.pos;
+        vector<int> newlyCovered;
+        ck.choose(r, newlyCovered);
+        if (!ck.replay()) return reject(ck.error);
+        ck.unchoose(r, newlyCovered);
+        for (int j = 0; j < numCand; ++j) {
+            if (find(j) == find(r)) ck.excluded[j] = 1;
+        }
+    }
+    if (ck.pos != ck.lines.size()) return reject("trailing lines after the last case");
+
+    cout << "s UNSATISFIABLE\nc verified " << reps.size() << " cases, "
+         << ck.nodesChecked << " nodes, " << gens.size() << " generators; " << reduction << "\n";
+    return 0;
+}
@@ -1,46 +1,63 @@
 // SAT encoding for Lonely Runner Conjecture verification
 // Translates Rosenfeld's verification into CNF (DIMACS format)
 // 
+// With --solve the formula goes to the in-tree CDCL solver instead of stdout,
+// and search effort is reported per constraint group (clause origin).
+// --threads N solves cubes over the candidate variables in parallel, splitting
+// a cube whenever a worker is idle and its conflict slice ends undecided.
+// --plan lets the preprocessing planner skip or cut the dominance passes.
+// --backbone reports the velocities in every covering and in none.
+// --partition P fixes the top branching velocities until the open times
+// split into P weakly coupled parts, and reports the fixed velocities and the
+// separator; parallel cubes split on those first.
+// --cache DIR checkpoints low-LBD learnt clauses (over all CNF variables,
+// auxiliaries included) and reloads them when the same formula is solved again.
+// --reductions FILE logs every dominance removal for lonely_cert_check. That
+// checks the reduction only, not the CNF or its symmetry-breaking clauses.
+// --propagator (with --solve) leaves coverage, exactly-k and the GCD limits
+// out of the CNF and enforces them with a domain propagator in the solver.
+//
 // David H. Silver, 2025
 // Based on Matthieu Rosenfeld's verification approach (arXiv:2509.14111)
 // GitHub Copilot was used for code formatting and boilerplate
 
-#include <iostream>
-#include <vector>
-#include <bitset>
-#include <algorithm>
-#include <functional>
-#include <map>
-#include <unordered_map>
-#include <chrono>
-using namespace std;
-
-#ifndef PRIME
-#define PRIME 43
-#endif
-
-#ifndef K
-#define K 7
-#endif
-
-constexpr int k = K;
-constexpr int prime = PRIME;
-
-constexpr int n = k + 1;
-constexpr int Q = n * prime;
-constexpr int maxM = Q / 2;
+#include "lonely_common.hpp"
+#include "cdcl_solver.hpp"
+#include "work_queue.hpp"
+#include "preprocess_planner.hpp"
+#include "symmetry.hpp"
+#include "hypergraph_partition.hpp"
+#include "learnt_cache.hpp"
+#include "cover_propagator.hpp"
+#include <deque>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <set>
+#include <sstream>
+#include <thread>
 
-// CNF builder
+// CNF builder; every clause is tagged with the group open when it was added
 
 struct CNF {
     int numVars = 0;
     vector<vector<int>> clauses;
+    vector<int> clauseGroup;
+    vector<string> groupNames;
+    int group = -1;
 
     int newVar() { return ++numVars; }
 
+    // Start a constraint group; later clauses belong to it
+    int beginGroup(const string& name) {
+        groupNames.push_back(name);
+        return group = (int)groupNames.size() - 1;
+    }
+
     void addClause(const vector<int>& lits) {
         if (lits.empty()) return; // avoid empty clause accidentally
         clauses.push_back(lits);
+        clauseGroup.push_back(group);
     }
 
     void printDIMACS(ostream& out) const {
@@ -92,6 +109,10 @@ int buildSequentialCounter(CNF& cnf, const vector<int>& xs, int R) {
                 } else {
                     cnf.addClause({ -s[i][j], xi });
                 }
+            } else if (j == i) {
+                // s[i][i] -> (xi ∧ s[i-1][i-1])
+                cnf.addClause({ -s[i][j], xi });
+                cnf.addClause({ -s[i][j], s[i - 1][j - 1] });
             } else if (j <= i - 1) {
                 // s[i][j] -> (s[i-1][j] ∨ (xi ∧ s[i-1][j-1]))
                 if (s[i - 1][j] != 0) {
@@ -112,10 +133,61 @@ int buildSequentialCounter(CNF& cnf, const vector<int>& xs, int R) {
     return s[n][R];
 }
 
-// At most R of xs are true
-void addAtMostK(CNF& cnf, const vector<int>& xs, int R) {
-    if ((int)xs.size() == 0 || R >= (int)xs.size()) return;
-    buildSequentialCounter(cnf, xs, R);  // Build counter, don't assert s[n][R]
+// At most R of xs are true; returns the "exactly R" (saturated) literal, or 0
+// when R >= |xs| and no counter is needed
+int addAtMostK(CNF& cnf, const vector<int>& xs, int R) {
+    if ((int)xs.size() == 0 || R >= (int)xs.size()) return 0;
+    return buildSequentialCounter(cnf, xs, R);  // Build counter, don't assert s[n][R]
+}
+
+// Conditional dominance over the essential times: if cover(a) ⊇ cover(b)
+// and a ranks above b, then b ∧ ¬a is allowed only when some prime class
+// that a would add a multiple to is saturated:
+//   (¬x_b ∨ x_a ∨ sat_q for q | a, q ∤ b)
+// Sound: swapping b for a keeps coverage and every GCD limit whenever those
+// classes have room, and strictly improves rank (|cover| desc, index asc),
+// which is also the order the equivalence-class clauses use. A negative
+// saturated entry is a class that can fill up but has no literal for it
+// (the limit is left to the propagator): pairs that need it are skipped.
+int addConditionalDominance(CNF& cnf, const vector<int>& xVars,
+                            const vector<int>& candidates,
+                            const vector<bitset<maxM>>& nearZero,
+                            const vector<int>& essentialTimes,
+                            const vector<int>& primeDivisors,
+                            const vector<int>& saturated) {
+    bitset<maxM> essentialMask;
+    for (int t : essentialTimes) essentialMask[t] = true;
+
+    int numCand = (int)candidates.size();
+    vector<bitset<maxM>> cover(numCand);
+    vector<int> size(numCand);
+    for (int j = 0; j < numCand; ++j) {
+        cover[j] = nearZero[candidates[j]] & essentialMask;
+        size[j] = (int)cover[j].count();
+    }
+
+    int added = 0;
+    for (int a = 0; a < numCand; ++a) {
+        for (int b = 0; b < numCand; ++b) {
+            if (a == b) continue;
+            if (size[a] < size[b] || (size[a] == size[b] && a > b)) continue;
+            if ((cover[a] | cover[b]) != cover[a]) continue;
+
+            vector<int> clause = { -xVars[b], xVars[a] };
+            bool escapable = true;
+            for (int d = 0; d < (int)primeDivisors.size(); ++d) {
+                int q = primeDivisors[d];
+                if (candidates[a] % q == 0 && candidates[b] % q != 0 && saturated[d] != 0) {
+                    escapable = saturated[d] > 0;
+                    clause.push_back(saturated[d]);
+                }
+            }
+            if (!escapable) continue;
+            cnf.addClause(clause);
+            ++added;
+        }
+    }
+    return added;
 }
 
 // Exactly K of xs must be true
@@ -129,107 +201,527 @@ void addExactlyK(CNF& cnf, const vector<int>& xs, int Kexact) {
     }
 }
 
-// Preprocessing: dominance reduction
-
-vector<int> getPrimeDivisors(int n) {
-    vector<int> divisors;
-    if (n == 3 || n == 5 || n == 7 || n == 11 || n == 13) {
-        divisors.push_back(n);
-    } else if (n == 4 || n == 8 || n == 16) {
-        divisors.push_back(2);
-    } else if (n == 6) {
-        divisors.push_back(2);
-        divisors.push_back(3);
-    } else if (n == 9) {
-        divisors.push_back(3);
-    } else if (n == 10) {
-        divisors.push_back(2);
-        divisors.push_back(5);
-    } else if (n == 12) {
-        divisors.push_back(2);
-        divisors.push_back(3);
-    } else if (n == 14) {
-        divisors.push_back(2);
-        divisors.push_back(7);
-    } else if (n == 15) {
-        divisors.push_back(3);
-        divisors.push_back(5);
-    }
-    return divisors;
+// Slot (ordered) encoding: k slots, slot i picks candidate index pos[i] with
+// pos[0] < pos[1] < ... < pos[k-1]. Order variables o[i][j] <-> (pos[i] >= j)
+// form a ladder; strict increase removes the k! slot permutations and gives
+// exactly k chosen without a cardinality network. Channeling ties slots to xs.
+// Returns sel[i][j] (literal "slot i picks j", 0 outside the slot's range).
+vector<vector<int>> addSlotEncoding(CNF& cnf, const vector<int>& xs, int slots) {
+    int N = (int)xs.size();
+    vector<vector<int>> sel(slots, vector<int>(N, 0));
+    if (slots <= 0 || slots > N) return sel;
+
+    // Slot i ranges over [i, N - slots + i]
+    vector<vector<int>> o(slots, vector<int>(N + 1, 0));
+    for (int i = 0; i < slots; ++i) {
+        int lo = i, hi = N - slots + i;
+        for (int j = lo + 1; j <= hi; ++j) {
+            o[i][j] = cnf.newVar();
+            if (j > lo + 1) cnf.addClause({ -o[i][j], o[i][j - 1] });  // ladder
+        }
+
+        if (lo == hi) {
+            sel[i][lo] = xs[lo];
+            cnf.addClause({ xs[lo] });  // slot forced
+            continue;
+        }
+        sel[i][lo] = -o[i][lo + 1];
+        sel[i][hi] = o[i][hi];
+        for (int j = lo + 1; j < hi; ++j) {
+            // sel <-> (pos >= j) ∧ ¬(pos >= j+1)
+            int e = cnf.newVar();
+            cnf.addClause({ -e, o[i][j] });
+            cnf.addClause({ -e, -o[i][j + 1] });
+            cnf.addClause({ -o[i][j], o[i][j + 1], e });
+            sel[i][j] = e;
+        }
+    }
+
+    // Strict increase: pos[i] >= j -> pos[i+1] >= j+1
+    for (int i = 0; i + 1 < slots; ++i) {
+        for (int j = i + 1; j <= N - slots + i; ++j) {
+            cnf.addClause({ -o[i][j], o[i + 1][j + 1] });
+        }
+    }
+
+    // Channeling: x_j <-> some slot picks j
+    for (int j = 0; j < N; ++j) {
+        vector<int> picks = { -xs[j] };
+        for (int i = 0; i < slots; ++i) {
+            if (sel[i][j] == 0) continue;
+            cnf.addClause({ -sel[i][j], xs[j] });
+            picks.push_back(sel[i][j]);
+        }
+        cnf.addClause(picks);
+    }
+    return sel;
 }
 
-// Check if velocity a dominates b (covers everything b does, GCD at least as restrictive)
-bool dominatesVelocity(int a, int b, const vector<bitset<maxM>>& nearZero, const vector<int>& primeDivisors) {
-    if ((nearZero[a] | nearZero[b]) != nearZero[a]) return false;
-    
-    for (int q : primeDivisors) {
-        if (b % q == 0 && a % q != 0) return false;
+// Solve in process and attribute effort to constraint groups. Coverage
+// groups (one per essential time) are summed into one row, and the times
+// the solver resolved on most are listed separately.
+void loadSolver(CDCLSolver& solver, const CNF& cnf) {
+    solver.reserveVars(cnf.numVars);
+    vector<int> solverGroup;
+    for (const string& name : cnf.groupNames) solverGroup.push_back(solver.addGroup(name));
+    for (size_t i = 0; i < cnf.clauses.size(); ++i) {
+        if (!solver.addClause(cnf.clauses[i], solverGroup[cnf.clauseGroup[i]])) break;
     }
-    
-    return true;
 }
 
-vector<int> reduceCandidatesByDominance(const vector<int>& candidates, 
-                                         const vector<bitset<maxM>>& nearZero,
-                                         const vector<int>& primeDivisors) {
-    int numCand = candidates.size();
-    vector<bool> dominated(numCand, false);
-    
-    for (int i = 0; i < numCand; ++i) {
-        if (dominated[i]) continue;
-        for (int j = 0; j < numCand; ++j) {
-            if (i == j || dominated[j]) continue;
-            if (dominatesVelocity(candidates[i], candidates[j], nearZero, primeDivisors)) {
-                dominated[j] = true;
+// Cubes are assumption lists over the candidate variables. Each worker
+// keeps its solver (and learnt clauses) across cubes and solves in slices
+// of sliceConflicts; an undecided slice while another worker is idle splits
+// the cube on the first free variable of splitFirst (the partition's
+// fixed velocities and separator, if any), else on the most active free candidate: one half is
+// queued, the worker continues with the other. Returns kSat/kUnsat; model
+// from the worker that found it.
+int solveCubes(vector<CDCLSolver>& solvers, const vector<int>& xVars, const vector<int>& splitFirst,
+               long long sliceConflicts, vector<char>& model, long long& cubes) {
+    WorkQueue<vector<int>> pool((int)solvers.size());
+    pool.push({});
+    mutex resultLock;
+    bool sat = false;
+
+    vector<thread> running;
+    for (auto& solver : solvers) {
+        running.emplace_back([&] {
+            vector<int> cube;
+            while (pool.pop(cube)) {
+                for (;;) {
+                    int status = solver.solve(cube, sliceConflicts);
+                    if (pool.isStopped() || status == CDCLSolver::kUnsat) break;
+                    if (status == CDCLSolver::kSat) {
+                        lock_guard<mutex> lock(resultLock);
+                        if (!sat) {
+                            sat = true;
+                            model.assign(xVars.size(), 0);
+                            for (size_t j = 0; j < xVars.size(); ++j) model[j] = solver.modelValue(xVars[j]);
+                        }
+                        pool.stop();
+                        break;
+                    }
+                    if (!pool.wantsWork()) continue;
+
+                    auto isFree = [&](int x) {
+                        for (int lit : cube) {
+                            if (abs(lit) == x) return false;
+                        }
+                        return true;
+                    };
+                    int split = 0;
+                    for (int x : splitFirst) {
+                        if (isFree(x)) {
+                            split = x;
+                            break;
+                        }
+                    }
+                    bool bySeparator = split != 0;
+                    for (int x : xVars) {
+                        if (bySeparator) break;
+                        if (isFree(x) && (!split || solver.activityOf(x) > solver.activityOf(split))) split = x;
+                    }
+                    if (!split) continue;
+                    vector<int> other = cube;
+                    other.push_back(-split);
+                    pool.push(other);
+                    cube.push_back(split);
+                }
             }
+        });
+    }
+    for (auto& t : running) t.join();
+    cubes = pool.tasksPushed();
+    return sat ? CDCLSolver::kSat : CDCLSolver::kUnsat;
+}
+
+bool solveWithAttribution(const CNF& cnf, const vector<int>& xVars, const vector<int>& candidates,
+                          int threads, long long sliceConflicts, const vector<int>& splitFirst,
+                          LearntCache* cache, long long checkpointConflicts,
+                          vector<CoverPropagator>* propagators) {
+    vector<CDCLSolver> solvers(threads);
+    for (auto& solver : solvers) loadSolver(solver, cnf);
+    if (propagators) {
+        // One propagator per worker: each follows its own solver's trail
+        for (int w = 0; w < threads; ++w) {
+            for (int x : xVars) solvers[w].observe(x);
+            solvers[w].connectPropagator(&(*propagators)[w], solvers[w].addGroup("propagator"));
         }
     }
-    
-    vector<int> reduced;
-    for (int i = 0; i < numCand; ++i) {
-        if (!dominated[i]) reduced.push_back(candidates[i]);
+    if (cache) {
+        // Earlier checkpoints go in as redundant clauses; every worker then
+        // checkpoints its own learnt clauses into the same file
+        vector<vector<int>> loaded = cache->load();
+        for (auto& solver : solvers) {
+            for (const auto& c : loaded) solver.addLearnt(c, cache->maxLbd);
+        }
+        cerr << "Learnt cache: " << loaded.size() << " clauses from " << cache->file() << "\n";
+        for (int w = 0; w < threads; ++w) {
+            solvers[w].setCheckpoint(checkpointConflicts, [&, w] {
+                cache->store(w, solvers[w].learntClauses(cnf.numVars, cache->maxLbd));
+            });
+        }
     }
-    return reduced;
-}
 
-vector<bitset<10000>> buildCoverageSets(const vector<int>& candidates,
-                                         const vector<bitset<maxM>>& nearZero) {
-    vector<bitset<10000>> cover;
-    cover.reserve(maxM);
-    
-    for (int t = 0; t < maxM; ++t) {
-        bitset<10000> coverSet;
-        for (int j = 0; j < (int)candidates.size(); ++j) {
-            if (nearZero[candidates[j]][t]) coverSet[j] = true;
+    auto t_start = chrono::high_resolution_clock::now();
+    int status;
+    vector<char> model;
+    if (threads == 1) {
+        status = solvers[0].solve();
+        if (status == CDCLSolver::kSat) {
+            for (int x : xVars) model.push_back(solvers[0].modelValue(x));
+        }
+    } else {
+        long long cubes;
+        status = solveCubes(solvers, xVars, splitFirst, sliceConflicts, model, cubes);
+        cerr << "Parallel: " << threads << " workers, " << cubes << " cubes\n";
+    }
+    auto t_end = chrono::high_resolution_clock::now();
+
+    // Totals and groups summed over workers
+    long long conflicts = 0, decisions = 0, propagations = 0;
+    vector<CDCLSolver::GroupStats> groups = solvers[0].groupStats();
+    for (auto& g : groups) g.clauses = g.conflicts = g.propagations = g.antecedents = 0;
+    for (const auto& solver : solvers) {
+        conflicts += solver.conflicts;
+        decisions += solver.decisions;
+        propagations += solver.propagations;
+        for (size_t i = 0; i < groups.size(); ++i) {
+            const auto& g = solver.groupStats()[i];
+            groups[i].clauses = max(groups[i].clauses, g.clauses);
+            groups[i].conflicts += g.conflicts;
+            groups[i].propagations += g.propagations;
+            groups[i].antecedents += g.antecedents;
+        }
+    }
+    cerr << "CDCL: " << conflicts << " conflicts, " << decisions << " decisions, "
+         << propagations << " propagations, "
+         << chrono::duration<double>(t_end - t_start).count() << "s\n";
+    if (cache) cerr << "Learnt cache: " << cache->lastStored() << " clauses at the last checkpoint\n";
+    if (propagators) {
+        long long implied = 0, coverage = 0, count = 0, packing = 0;
+        for (const auto& p : *propagators) {
+            implied += p.implied;
+            coverage += p.coverageConflicts;
+            count += p.countConflicts;
+            packing += p.packingConflicts;
+        }
+        cerr << "Propagator: " << implied << " implied literals, conflicts: " << coverage << " coverage, "
+             << count << " cardinality/GCD, " << packing << " packing\n";
+    }
+
+    // Sum the per-time coverage groups into one row
+    vector<CDCLSolver::GroupStats> rows, coverage;
+    CDCLSolver::GroupStats coverTotal;
+    coverTotal.name = "coverage";
+    for (const auto& g : groups) {
+        if (g.name.rfind("coverage ", 0) == 0) {
+            coverage.push_back(g);
+            coverTotal.clauses += g.clauses;
+            coverTotal.conflicts += g.conflicts;
+            coverTotal.propagations += g.propagations;
+            coverTotal.antecedents += g.antecedents;
+        } else {
+            rows.push_back(g);
         }
-        cover.push_back(coverSet);
     }
-    return cover;
+    if (!coverage.empty()) rows.insert(rows.begin() + 1, coverTotal);
+
+    long long totalAntecedents = 0;
+    for (const auto& g : rows) totalAntecedents += g.antecedents;
+    auto printRow = [&](const CDCLSolver::GroupStats& g) {
+        cerr << "  " << left << setw(18) << g.name << right << setw(9) << g.clauses
+             << setw(11) << g.conflicts << setw(14) << g.propagations << setw(13) << g.antecedents
+             << setw(7) << fixed << setprecision(1)
+             << (totalAntecedents ? 100.0 * g.antecedents / totalAntecedents : 0.0) << "%\n";
+        cerr.unsetf(ios::floatfield);
+        cerr << setprecision(6);
+    };
+    cerr << "  group               clauses  conflicts  propagations  antecedents  share\n";
+    for (const auto& g : rows) printRow(g);
+
+    sort(coverage.begin(), coverage.end(), [](const auto& a, const auto& b) {
+        return a.antecedents > b.antecedents;
+    });
+    if (coverage.size() > 5) coverage.resize(5);
+    cerr << "  hardest times:\n";
+    for (const auto& g : coverage) printRow(g);
+
+    if (status == CDCLSolver::kSat) {
+        cout << "s SATISFIABLE\nv";
+        for (size_t j = 0; j < xVars.size(); ++j) {
+            if (model[j]) cout << " " << candidates[j];
+        }
+        cout << " 0\n";
+    } else {
+        cout << "s UNSATISFIABLE\n";
+    }
+    return status == CDCLSolver::kSat;
 }
 
-vector<int> reduceTimesByDominance(const vector<bitset<10000>>& cover) {
-    int numTimes = cover.size();
-    vector<bool> redundant(numTimes, false);
-    
-    for (int t1 = 0; t1 < numTimes; ++t1) {
-        if (redundant[t1]) continue;
-        for (int t2 = 0; t2 < numTimes; ++t2) {
-            if (t1 == t2 || redundant[t2]) continue;
-            // If cover[t1] ⊆ cover[t2], then t2 redundant (clause implied)
-            if ((cover[t1] | cover[t2]) == cover[t2]) redundant[t2] = true;
+// Backbone over the candidate variables: velocities in every covering
+// (forced in) and in none (forced out). A literal stays a backbone
+// candidate while every covering seen so far agrees with it. Coverings
+// come from the solver and from rotation: images under the ±unit group,
+// and swaps of one chosen velocity for an unchosen one that covers the
+// times only it covered, within the GCD limits. Rotations are walked
+// breadth-first from every solver model. Coverings are closed under the
+// unit maps, so the backbone is a union of orbits and only one member per
+// orbit is tested. The remaining candidates are tested in chunks by assuming all their
+// negations at once. SAT filters the whole chunk. On UNSAT, a core of one
+// assumption proves that literal and it is added as a unit; a larger core
+// sends the chunk back to single tests. budget caps the conflicts per call,
+// and literals that run out are reported as undecided. Seed coverings are
+// checked against this reduced instance first; any other seed is rejected.
+void extractBackbone(const CNF& cnf, const vector<int>& xVars, const vector<int>& candidates,
+                     const vector<bitset<maxM>>& nearZero, const vector<int>& essentialTimes,
+                     const vector<int>& primeDivisors, long long budget,
+                     const vector<vector<int>>& seeds) {
+    auto t_start = chrono::high_resolution_clock::now();
+    CDCLSolver solver;
+    loadSolver(solver, cnf);
+    int unitGroup = solver.addGroup("backbone");
+
+    int numCand = (int)candidates.size();
+    bitset<maxM> essentialMask;
+    for (int t : essentialTimes) essentialMask[t] = true;
+    vector<bitset<maxM>> cover(numCand);
+    vector<uint32_t> multiples(numCand, 0);
+    for (int j = 0; j < numCand; ++j) {
+        cover[j] = nearZero[candidates[j]] & essentialMask;
+        for (int d = 0; d < (int)primeDivisors.size(); ++d) {
+            if (candidates[j] % primeDivisors[d] == 0) multiples[j] |= 1u << d;
         }
     }
-    
-    vector<int> essential;
-    for (int t = 0; t < numTimes; ++t) {
-        if (!redundant[t]) essential.push_back(t);
+    int gcdLimit = max(0, k - 2);
+
+    // Unit maps v -> ±uv that keep the candidate set, as index maps
+    vector<vector<int>> unitImage;
+    vector<int> indexOf(maxM + 1, -1);
+    for (int j = 0; j < numCand; ++j) indexOf[candidates[j]] = j;
+    for (int u : unitGroupElements()) {
+        vector<int> image(numCand);
+        bool closed = true;
+        for (int j = 0; j < numCand && closed; ++j) {
+            image[j] = indexOf[foldMod((long long)candidates[j] * u)];
+            closed = image[j] >= 0;
+        }
+        if (closed && u != 1) unitImage.push_back(move(image));
     }
-    return essential;
+
+    // The set of coverings is closed under these maps, so the backbone is a
+    // union of orbits: only the smallest member of each orbit is tested
+    vector<int> orbitRep(numCand, -1);
+    for (int j = 0; j < numCand; ++j) {
+        if (orbitRep[j] >= 0) continue;
+        orbitRep[j] = j;
+        vector<int> stack = { j };
+        while (!stack.empty()) {
+            int i = stack.back();
+            stack.pop_back();
+            for (const auto& image : unitImage) {
+                if (orbitRep[image[i]] < 0) {
+                    orbitRep[image[i]] = j;
+                    stack.push_back(image[i]);
+                }
+            }
+        }
+    }
+
+    // maybeIn[j]: j chosen in every covering seen; maybeOut[j]: in none
+    vector<char> maybeIn(numCand, 1), maybeOut(numCand, 1);
+    set<vector<int>> seen;
+    long long solverCalls = 0, unitRotations = 0, swapRotations = 0;
+    const size_t maxRotations = 100000;
+
+    auto absorb = [&](vector<int> chosen) {
+        sort(chosen.begin(), chosen.end());
+        if (!seen.insert(chosen).second) return;
+        deque<vector<int>> pending = { chosen };
+        while (!pending.empty()) {
+            vector<int> S = move(pending.front());
+            pending.pop_front();
+            vector<char> in(numCand, 0);
+            for (int j : S) in[j] = 1;
+            for (int j = 0; j < numCand; ++j) (in[j] ? maybeOut[j] : maybeIn[j]) = 0;
+
+            // Images under the unit group are coverings as well
+            for (const auto& image : unitImage) {
+                vector<int> next;
+                for (int j : S) next.push_back(image[j]);
+                sort(next.begin(), next.end());
+                if (seen.size() >= maxRotations || !seen.insert(next).second) continue;
+                ++unitRotations;
+                pending.push_back(move(next));
+            }
+
+            // Times covered exactly once
+            bitset<maxM> once, twice;
+            for (int j : S) {
+                twice |= once & cover[j];
+                once |= cover[j];
+            }
+            once &= ~twice;
+            vector<int> classCount(primeDivisors.size(), 0);
+            for (int j : S) {
+                for (int d = 0; d < (int)primeDivisors.size(); ++d) classCount[d] += multiples[j] >> d & 1;
+            }
+            for (int v : S) {
+                bitset<maxM> need = cover[v] & once;
+                for (int w = 0; w < numCand; ++w) {
+                    if (in[w] || !(maybeIn[v] || maybeOut[w])) continue;
+                    if ((need & ~cover[w]).any()) continue;
+                    bool fits = true;
+                    for (int d = 0; d < (int)primeDivisors.size(); ++d) {
+                        int c = classCount[d] - (multiples[v] >> d & 1) + (multiples[w] >> d & 1);
+                        fits &= c <= gcdLimit;
+                    }
+                    if (!fits) continue;
+                    vector<int> next = S;
+                    *find(next.begin(), next.end(), v) = w;
+                    sort(next.begin(), next.end());
+                    if (seen.size() >= maxRotations || !seen.insert(next).second) continue;
+                    ++swapRotations;
+                    pending.push_back(move(next));
+                }
+            }
+        }
+    };
+    auto solverModel = [&]() {
+        vector<int> chosen;
+        for (int j = 0; j < numCand; ++j) {
+            if (solver.modelValue(xVars[j])) chosen.push_back(j);
+        }
+        return chosen;
+    };
+
+    // A seed counts only if it is a covering of this reduced instance: k
+    // distinct candidates over every essential time within the GCD limits
+    auto seedError = [&](const vector<int>& velocities, vector<int>& chosen) -> string {
+        for (int v : velocities) {
+            if (v < 1 || v > maxM || indexOf[v] < 0) return "velocity " + to_string(v) + " is not a candidate";
+            chosen.push_back(indexOf[v]);
+        }
+        sort(chosen.begin(), chosen.end());
+        if (adjacent_find(chosen.begin(), chosen.end()) != chosen.end()) return "repeated velocity";
+        if ((int)chosen.size() != k) return to_string(chosen.size()) + " velocities, not " + to_string(k);
+        bitset<maxM> covered;
+        vector<int> classCount(primeDivisors.size(), 0);
+        for (int j : chosen) {
+            covered |= cover[j];
+            for (int d = 0; d < (int)primeDivisors.size(); ++d) classCount[d] += multiples[j] >> d & 1;
+        }
+        if (covered != essentialMask) return to_string((essentialMask & ~covered).count()) + " times uncovered";
+        for (int d = 0; d < (int)primeDivisors.size(); ++d) {
+            if (classCount[d] > gcdLimit) return "too many multiples of " + to_string(primeDivisors[d]);
+        }
+        return "";
+    };
+
+    // Known coverings (e.g. from the native search) replace the first solve
+    vector<int> witness;
+    for (size_t s = 0; s < seeds.size(); ++s) {
+        vector<int> chosen;
+        string error = seedError(seeds[s], chosen);
+        if (!error.empty()) {
+            cerr << "Backbone: seed " << s + 1 << " rejected: " << error << "\n";
+            continue;
+        }
+        if (witness.empty()) witness = chosen;
+        absorb(chosen);
+    }
+    int status = CDCLSolver::kSat;
+    if (witness.empty()) {
+        ++solverCalls;
+        status = solver.solve({}, budget);
+        if (status == CDCLSolver::kSat) witness = solverModel();
+    }
+    if (status != CDCLSolver::kSat) {
+        cerr << "Backbone: " << (status == CDCLSolver::kUnsat ? "no covering" : "first solve ran out of budget")
+             << "\n";
+        cout << (status == CDCLSolver::kUnsat ? "s UNSATISFIABLE\n" : "s UNKNOWN\n");
+        return;
+    }
+    absorb(witness);
+
+    // Backbone literal for j: +x if j may be forced in, -x if forced out
+    vector<char> forcedIn(numCand, 0), forcedOut(numCand, 0), undecided(numCand, 0);
+    auto open = [&](int j) {
+        return orbitRep[j] == j && (maybeIn[j] || maybeOut[j]) && !forcedIn[j] && !forcedOut[j] && !undecided[j];
+    };
+    // Settle j's whole orbit
+    auto settle = [&](int j, vector<char>& verdict) {
+        for (int i = 0; i < numCand; ++i) {
+            if (orbitRep[i] == orbitRep[j]) verdict[i] = 1;
+        }
+    };
+    auto literal = [&](int j) { return maybeIn[j] ? xVars[j] : -xVars[j]; };
+    size_t chunk = 1;
+    for (;;) {
+        vector<int> tested;
+        for (int j = 0; j < numCand && tested.size() < chunk; ++j) {
+            if (open(j)) tested.push_back(j);
+        }
+        if (tested.empty()) break;
+        vector<int> assumptions;
+        for (int j : tested) assumptions.push_back(-literal(j));
+
+        ++solverCalls;
+        status = solver.solve(assumptions, budget);
+        if (status == CDCLSolver::kSat) {
+            absorb(solverModel());
+            chunk = min<size_t>(2 * chunk, 32);
+        } else if (status == CDCLSolver::kUnsat) {
+            const vector<int>& core = solver.failedAssumptions();
+            if (core.empty()) break;   // cannot happen: only implied units were added
+            if (core.size() == 1) {
+                int j = -1;
+                for (int i : tested) {
+                    if (-literal(i) == core[0]) j = i;
+                }
+                settle(j, maybeIn[j] ? forcedIn : forcedOut);
+                for (int i = 0; i < numCand; ++i) {
+                    if (orbitRep[i] == orbitRep[j]) solver.addClause({ literal(i) }, unitGroup);
+                }
+            }
+            chunk = 1;
+        } else {
+            if (tested.size() == 1) settle(tested[0], undecided);
+            chunk = 1;
+        }
+    }
+    auto t_end = chrono::high_resolution_clock::now();
+
+    int numIn = 0, numOut = 0, numUndecided = 0;
+    for (int j = 0; j < numCand; ++j) {
+        numIn += forcedIn[j];
+        numOut += forcedOut[j];
+        numUndecided += undecided[j];
+    }
+    cerr << "Backbone: " << numIn << " forced in, " << numOut << " forced out, " << numUndecided
+         << " undecided, " << numCand - numIn - numOut - numUndecided << " free; " << solverCalls
+         << " solver calls, " << seen.size() << " coverings (" << unitRotations << " by unit map, "
+         << swapRotations << " by swap), "
+         << solver.conflicts << " conflicts, " << chrono::duration<double>(t_end - t_start).count() << "s\n";
+
+    auto printSet = [&](const char* tag, const vector<char>& member) {
+        cout << tag;
+        for (int j = 0; j < numCand; ++j) {
+            if (member[j]) cout << " " << candidates[j];
+        }
+        cout << " 0\n";
+    };
+    cout << "s SATISFIABLE\nv";
+    for (int j : witness) cout << " " << candidates[j];
+    cout << " 0\n";
+    printSet("i", forcedIn);
+    printSet("o", forcedOut);
+    printSet("u", undecided);
 }
 
 // Main encoding
 
-int main() {
+int main(int argc, char** argv) {
     ios::sync_with_stdio(false);
     cin.tie(nullptr);
 
@@ -238,38 +730,58 @@ int main() {
          << ", Q = " << Q
          << ", maxM = " << maxM << "\n";
 
-    // Precompute coverage: nearZero[v][t] = (||tv/Q|| < 1/n)
-    vector<bitset<maxM>> nearZero;
-    nearZero.reserve(maxM + 1);
-
-    for (int i = 0; i <= maxM; ++i) {
-        bitset<maxM> currLine;
-        for (int t = 1; t <= maxM; ++t) {
-            int ti = (t * i) % Q;
-            bool close = (ti * n < Q) || ((Q - ti) * n < Q);
-            currLine[maxM - t] = close;
-        }
-        nearZero.push_back(currLine);
+    bool solve = false;
+    int threads = 1;
+    long long sliceConflicts = 2000;
+    bool plan = false;
+    bool backbone = false;
+    long long budget = -1;
+    string seedPath;
+    int parts = 0;
+    string cacheDir;
+    long long checkpointConflicts = 20000;
+    int maxLbd = 10;
+    string reductionsPath;
+    bool propagator = false;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--solve") solve = true;
+        if (arg == "--plan") plan = true;
+        if (arg == "--backbone") backbone = true;
+        if (arg == "--budget" && i + 1 < argc) budget = atoll(argv[++i]);
+        if (arg == "--seed" && i + 1 < argc) seedPath = argv[++i];
+        if (arg == "--threads" && i + 1 < argc) threads = max(1, atoi(argv[++i]));
+        if (arg == "--slice" && i + 1 < argc) sliceConflicts = atoll(argv[++i]);
+        if (arg == "--partition" && i + 1 < argc) parts = max(2, atoi(argv[++i]));
+        if (arg == "--cache" && i + 1 < argc) cacheDir = argv[++i];
+        if (arg == "--checkpoint" && i + 1 < argc) checkpointConflicts = max(1LL, atoll(argv[++i]));
+        if (arg == "--max-lbd" && i + 1 < argc) maxLbd = atoi(argv[++i]);
+        if (arg == "--reductions" && i + 1 < argc) reductionsPath = argv[++i];
+        if (arg == "--propagator") propagator = true;
     }
 
+    vector<bitset<maxM>> nearZero = buildNearZero();
+
     auto t_start = chrono::high_resolution_clock::now();
 
-    // Initial candidates: [1..maxM] \ pZ
-    vector<int> candidates;
-    candidates.reserve(maxM);
-    for (int i = 1; i <= maxM; ++i) {
-        if (i % prime == 0) continue;
-        candidates.push_back(i);
-    }
+    vector<int> candidates = initialCandidates();
 
     int numCandidatesInitial = (int)candidates.size();
     cerr << "Initial candidates: " << numCandidatesInitial << "\n";
 
     vector<int> primeDivisors = getPrimeDivisors(n);
+    ReductionLog velocitySteps, timeSteps;
+    bool logSteps = !reductionsPath.empty();
     
     // Preprocessing: velocity dominance
     auto t_dom_start = chrono::high_resolution_clock::now();
-    candidates = reduceCandidatesByDominance(candidates, nearZero, primeDivisors);
+    PassPlan velocityPlan, timePlan, conditionalPlan;
+    if (plan) {
+        velocityPlan = planVelocityDominance(candidates, nearZero, primeDivisors);
+        velocityPlan.report(cerr);
+    }
+    candidates = reduceCandidatesByDominance(candidates, nearZero, primeDivisors, velocityPlan.depth,
+                                             logSteps ? &velocitySteps : nullptr);
     auto t_dom_end = chrono::high_resolution_clock::now();
     
     cerr << "After velocity dominance: " << candidates.size()
@@ -280,7 +792,16 @@ int main() {
     
     // Preprocessing: time dominance
     auto t_time_start = chrono::high_resolution_clock::now();
-    vector<int> essentialTimes = reduceTimesByDominance(coverSets);
+    if (plan) {
+        timePlan = planTimeDominance(coverSets);
+        timePlan.report(cerr);
+    }
+    vector<int> essentialTimes = reduceTimesByDominance(coverSets, timePlan.depth, logSteps ? &timeSteps : nullptr);
+    if (logSteps) {
+        ofstream out(reductionsPath);
+        out << "p lonely " << k << " " << prime << "\n";
+        writeReductionSteps(out, velocitySteps, timeSteps);
+    }
     auto t_time_end = chrono::high_resolution_clock::now();
     
     cerr << "After time dominance: " << essentialTimes.size()
@@ -293,6 +814,37 @@ int main() {
 
     int numCandidates = (int)candidates.size();
 
+    // Decomposition: a residual, after the top branching literals, whose
+    // parts are coupled only through the separator
+    vector<int> separator;
+    if (parts) {
+        auto t_part_start = chrono::high_resolution_clock::now();
+        Decomposition d = decomposeResidual(candidates, nearZero, essentialTimes, primeDivisors, parts);
+        cerr << "Partition: " << d.fixed.size() << " fixed, " << d.openTimes.size() << " of "
+             << essentialTimes.size() << " times open, " << d.parts << " parts of";
+        for (int p = 0; p < d.parts; ++p) {
+            cerr << (p ? "/" : " ") << d.partTimes[p];
+        }
+        cerr << " times and";
+        for (int p = 0; p < d.parts; ++p) {
+            cerr << (p ? "/" : " ") << d.partSize[p];
+        }
+        cerr << " candidates, separator " << d.separator.size() << " of " << d.live << " live candidates, "
+             << chrono::duration<double>(chrono::high_resolution_clock::now() - t_part_start).count() << "s\n";
+        if (d.decomposes()) {
+            cerr << "  fixed:";
+            for (int j : d.fixed) cerr << " " << candidates[j];
+            cerr << "\n  separator:";
+            for (int j : d.separator) cerr << " " << candidates[j];
+            cerr << "\n\n";
+            separator = d.fixed;
+            separator.insert(separator.end(), d.separator.begin(), d.separator.end());
+        } else {
+            // Even k-1 fixed velocities leave the open times tightly coupled
+            cerr << "  no decomposition: the separator holds most live candidates\n\n";
+        }
+    }
+
     // CNF builder
     CNF cnf;
 
@@ -302,9 +854,15 @@ int main() {
         xVars[j] = cnf.newVar();
     }
 
+    // With the propagator, coverage, exactly-k and the GCD limits stay out
+    // of the CNF; only the candidate variables and side clauses remain
+    bool domain = propagator && solve && !backbone;
+
     // Coverage clauses
     int uncoverable_count = 0;
     for (int t : essentialTimes) {
+        if (domain) break;
+        cnf.beginGroup("coverage t=" + to_string(maxM - t));
         vector<int> clause;
         for (int j = 0; j < numCandidates; ++j) {
             if (nearZero[candidates[j]][t]) {
@@ -329,24 +887,131 @@ int main() {
     }
 
     // Exactly k chosen
-    addExactlyK(cnf, xVars, k);
+#ifdef SLOT_ENCODING
+    cnf.beginGroup("slots");
+    vector<vector<int>> slotSel;
+    if (!domain) {
+        slotSel = addSlotEncoding(cnf, xVars, k);
+        cerr << "Slot encoding: " << k << " ordered slots over " << numCandidates << " candidates\n";
+    }
+#else
+    if (!domain) {
+        cnf.beginGroup("exactly-k");
+        addExactlyK(cnf, xVars, k);
+    }
+#endif
+
+    // Equivalence classes: take members in order (x_{j+1} -> x_j), so each
+    // class count has one model; counts scale by the binomial multiplicities
+    auto classes = groupEquivalentCandidates(candidates, nearZero, essentialTimes, primeDivisors);
+    int orderClauses = 0;
+    cnf.beginGroup("equivalence");
+    // The backbone needs every covering, not one per symmetry class
+    if (backbone) classes.clear();
+    for (const auto& cls : classes) {
+        for (int i = 0; i + 1 < (int)cls.size(); ++i) {
+            cnf.addClause({ -xVars[cls[i + 1]], xVars[cls[i]] });
+            ++orderClauses;
+        }
+    }
+    cerr << "Equivalence classes: " << classes.size() << " over " << numCandidates
+         << " candidates (" << orderClauses << " ordering clauses)\n";
 
     // GCD constraints: at most k-2 multiples of each prime dividing (k+1)
 
+    vector<int> saturated;
     for (int d : primeDivisors) {
+        if (domain) {
+            // The propagator keeps the limit; there is no saturation literal
+            int count = (int)count_if(candidates.begin(), candidates.end(), [&](int v) { return v % d == 0; });
+            saturated.push_back(count > max(0, k - 2) ? -1 : 0);
+            continue;
+        }
+        cnf.beginGroup("gcd q=" + to_string(d));
         vector<int> lits;
+#ifdef SLOT_ENCODING
+        // Count over slots: m_i true if slot i picks a multiple of d
+        bool anyMultiple = false;
+        for (int j = 0; j < numCandidates; ++j) anyMultiple |= (candidates[j] % d == 0);
+        for (int i = 0; anyMultiple && i < k; ++i) {
+            int m = cnf.newVar();
+            for (int j = 0; j < numCandidates; ++j) {
+                if (slotSel[i][j] != 0 && candidates[j] % d == 0) {
+                    cnf.addClause({ -slotSel[i][j], m });
+                }
+            }
+            lits.push_back(m);
+        }
+#else
         for (int j = 0; j < numCandidates; ++j) {
             int v = candidates[j];
             if (v % d == 0) {
                 lits.push_back(+xVars[j]);
             }
         }
+#endif
         if (!lits.empty()) {
             int limit = max(0, k - 2);
-            addAtMostK(cnf, lits, limit);
+            saturated.push_back(addAtMostK(cnf, lits, limit));
             cerr << "GCD constraint: at most " << limit << " of " << lits.size() 
                  << " velocities divisible by " << d << "\n";
+        } else {
+            saturated.push_back(0);
+        }
+    }
+
+    cnf.beginGroup("dominance");
+    if (plan) {
+        conditionalPlan = planConditionalDominance(candidates, nearZero, essentialTimes);
+        conditionalPlan.report(cerr);
+    }
+    int condClauses = 0;
+    if (conditionalPlan.depth != 0 && !backbone) {
+        condClauses = addConditionalDominance(cnf, xVars, candidates, nearZero, essentialTimes,
+                                              primeDivisors, saturated);
+    }
+    cerr << "Conditional dominance: " << condClauses << " clauses\n";
+
+    vector<int> splitFirst;
+    for (int j : separator) splitFirst.push_back(xVars[j]);
+
+    if (backbone) {
+        cerr << "\nCNF: " << cnf.numVars << " vars, " << cnf.clauses.size() << " clauses\n";
+        // Seed coverings: "v <velocities> 0" lines, as printed by either engine
+        vector<vector<int>> seeds;
+        ifstream seedFile(seedPath);
+        string line;
+        while (getline(seedFile, line)) {
+            istringstream in(line);
+            string tag;
+            int v;
+            if (!(in >> tag) || tag != "v") continue;
+            seeds.push_back({});
+            while (in >> v && v != 0) seeds.back().push_back(v);
+        }
+        extractBackbone(cnf, xVars, candidates, nearZero, essentialTimes, primeDivisors, budget, seeds);
+        return 0;
+    }
+
+    if (solve) {
+        cerr << "\nCNF: " << cnf.numVars << " vars, " << cnf.clauses.size() << " clauses\n";
+        // The hash pins the whole formula, auxiliary numbering included
+        unique_ptr<LearntCache> cache;
+        if (!cacheDir.empty()) {
+            cache = make_unique<LearntCache>(cacheDir, k, prime, hashFormula(cnf.numVars, cnf.clauses),
+                                             cnf.numVars, threads);
+            cache->maxLbd = maxLbd;
+        }
+        vector<CoverPropagator> propagators;
+        if (domain) {
+            propagators.assign(threads, CoverPropagator(xVars, candidates, nearZero, essentialTimes, primeDivisors));
+            cerr << "Propagator: coverage of " << essentialTimes.size() << " times, exactly " << k
+                 << " and the GCD limits\n";
         }
+        solveWithAttribution(cnf, xVars, candidates, threads, sliceConflicts, splitFirst, cache.get(),
+                             checkpointConflicts, domain ? &propagators : nullptr);
+        reportPeakRss(cerr);
+        return 0;
     }
 
     // Output CNF
@@ -359,6 +1024,7 @@ int main() {
     }
     
     cerr << "\nCNF: " << cnf.numVars << " vars, " << cnf.clauses.size() << " clauses\n";
+    reportPeakRss(cerr);
 
     return 0;
 }
@@ -0,0 +1,281 @@
+// Shared instance setup and preprocessing for the Lonely Runner tools
+// (CNF generator and native search). Parameters are compile-time:
+//   g++ -O3 -DK=8 -DPRIME=31 ...
+//
+// David H. Silver, 2025
+// Based on Matthieu Rosenfeld's verification approach (arXiv:2509.14111)
+
+#pragma once
+
+#include <iostream>
+#include <vector>
+#include <bitset>
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <unordered_map>
+#include <chrono>
+#include <iomanip>
+#include <sys/resource.h>
+using namespace std;
+
+#ifndef PRIME
+#define PRIME 43
+#endif
+
+#ifndef K
+#define K 7
+#endif
+
+constexpr int k = K;
+constexpr int prime = PRIME;
+
+constexpr int n = k + 1;
+constexpr int Q = n * prime;
+constexpr int maxM = Q / 2;
+
+// Coverage: nearZero[v][maxM - t] = (||tv/Q|| < 1/n), for v, t in [1..maxM]
+vector<bitset<maxM>> buildNearZero() {
+    vector<bitset<maxM>> nearZero;
+    nearZero.reserve(maxM + 1);
+
+    for (int i = 0; i <= maxM; ++i) {
+        bitset<maxM> currLine;
+        for (int t = 1; t <= maxM; ++t) {
+            int ti = (t * i) % Q;
+            bool close = (ti * n < Q) || ((Q - ti) * n < Q);
+            currLine[maxM - t] = close;
+        }
+        nearZero.push_back(currLine);
+    }
+    return nearZero;
+}
+
+// Initial candidates: [1..maxM] \ pZ
+vector<int> initialCandidates() {
+    vector<int> candidates;
+    candidates.reserve(maxM);
+    for (int i = 1; i <= maxM; ++i) {
+        if (i % prime == 0) continue;
+        candidates.push_back(i);
+    }
+    return candidates;
+}
+
+// Preprocessing: dominance reduction
+
+vector<int> getPrimeDivisors(int n) {
+    vector<int> divisors;
+    if (n == 3 || n == 5 || n == 7 || n == 11 || n == 13) {
+        divisors.push_back(n);
+    } else if (n == 4 || n == 8 || n == 16) {
+        divisors.push_back(2);
+    } else if (n == 6) {
+        divisors.push_back(2);
+        divisors.push_back(3);
+    } else if (n == 9) {
+        divisors.push_back(3);
+    } else if (n == 10) {
+        divisors.push_back(2);
+        divisors.push_back(5);
+    } else if (n == 12) {
+        divisors.push_back(2);
+        divisors.push_back(3);
+    } else if (n == 14) {
+        divisors.push_back(2);
+        divisors.push_back(7);
+    } else if (n == 15) {
+        divisors.push_back(3);
+        divisors.push_back(5);
+    }
+    return divisors;
+}
+
+// Check if velocity a dominates b (covers everything b does, GCD at least as restrictive)
+// Swapping b for a must not add a multiple of any q: the GCD limits are upper bounds
+bool dominatesVelocity(int a, int b, const vector<bitset<maxM>>& nearZero, const vector<int>& primeDivisors) {
+    if ((nearZero[a] | nearZero[b]) != nearZero[a]) return false;
+    
+    for (int q : primeDivisors) {
+        if (a % q == 0 && b % q != 0) return false;
+    }
+    
+    return true;
+}
+
+// Candidate indices, largest cover first: the likeliest dominators
+vector<int> velocityDominatorOrder(const vector<int>& candidates, const vector<bitset<maxM>>& nearZero) {
+    vector<int> order(candidates.size());
+    for (int i = 0; i < (int)order.size(); ++i) order[i] = i;
+    stable_sort(order.begin(), order.end(), [&](int a, int b) {
+        return nearZero[candidates[a]].count() > nearZero[candidates[b]].count();
+    });
+    return order;
+}
+
+// Removals of a dominance pass in the order applied: (removed, dominator),
+// as velocities or as times t in [1..maxM]. The dominator is still present
+// when the removal is made, so each step can be checked on its own.
+typedef vector<pair<int, int>> ReductionLog;
+
+// Steps as certificate lines: "D nd ne" with the step counts, then nd lines
+// "d v a" (velocity v, dominated by a) and ne lines "e t s" (time t,
+// implied by covering s)
+void writeReductionSteps(ostream& out, const ReductionLog& velocities, const ReductionLog& times) {
+    out << "D " << velocities.size() << " " << times.size() << "\n";
+    for (auto [v, a] : velocities) out << "d " << v << " " << a << "\n";
+    for (auto [t, s] : times) out << "e " << t << " " << s << "\n";
+}
+
+// depth >= 0 tries only the first depth dominators of velocityDominatorOrder
+// (see preprocess_planner.hpp); the default is the full pass in index order
+vector<int> reduceCandidatesByDominance(const vector<int>& candidates, 
+                                         const vector<bitset<maxM>>& nearZero,
+                                         const vector<int>& primeDivisors,
+                                         int depth = -1, ReductionLog* log = nullptr) {
+    int numCand = candidates.size();
+    vector<bool> dominated(numCand, false);
+    vector<int> dominators(numCand);
+    for (int i = 0; i < numCand; ++i) dominators[i] = i;
+    if (depth >= 0) {
+        dominators = velocityDominatorOrder(candidates, nearZero);
+        dominators.resize(min(depth, numCand));
+    }
+    
+    for (int i : dominators) {
+        if (dominated[i]) continue;
+        for (int j = 0; j < numCand; ++j) {
+            if (i == j || dominated[j]) continue;
+            if (dominatesVelocity(candidates[i], candidates[j], nearZero, primeDivisors)) {
+                dominated[j] = true;
+                if (log) log->push_back({ candidates[j], candidates[i] });
+            }
+        }
+    }
+    
+    vector<int> reduced;
+    for (int i = 0; i < numCand; ++i) {
+        if (!dominated[i]) reduced.push_back(candidates[i]);
+    }
+    return reduced;
+}
+
+vector<bitset<10000>> buildCoverageSets(const vector<int>& candidates,
+                                         const vector<bitset<maxM>>& nearZero) {
+    vector<bitset<10000>> cover;
+    cover.reserve(maxM);
+    
+    for (int t = 0; t < maxM; ++t) {
+        bitset<10000> coverSet;
+        for (int j = 0; j < (int)candidates.size(); ++j) {
+            if (nearZero[candidates[j]][t]) coverSet[j] = true;
+        }
+        cover.push_back(coverSet);
+    }
+    return cover;
+}
+
+// Times, smallest cover first: the likeliest to make others redundant
+vector<int> timeDominatorOrder(const vector<bitset<10000>>& cover) {
+    vector<int> order(cover.size());
+    for (int t = 0; t < (int)order.size(); ++t) order[t] = t;
+    stable_sort(order.begin(), order.end(), [&](int a, int b) { return cover[a].count() < cover[b].count(); });
+    return order;
+}
+
+// depth >= 0 tries only the first depth times of timeDominatorOrder
+vector<int> reduceTimesByDominance(const vector<bitset<10000>>& cover, int depth = -1,
+                                   ReductionLog* log = nullptr) {
+    int numTimes = cover.size();
+    vector<bool> redundant(numTimes, false);
+    vector<int> dominators(numTimes);
+    for (int t = 0; t < numTimes; ++t) dominators[t] = t;
+    if (depth >= 0) {
+        dominators = timeDominatorOrder(cover);
+        dominators.resize(min(depth, numTimes));
+    }
+    
+    for (int t1 : dominators) {
+        if (redundant[t1]) continue;
+        for (int t2 = 0; t2 < numTimes; ++t2) {
+            if (t1 == t2 || redundant[t2]) continue;
+            // If cover[t1] ⊆ cover[t2], then t2 redundant (clause implied)
+            if ((cover[t1] | cover[t2]) == cover[t2]) {
+                redundant[t2] = true;
+                if (log) log->push_back({ maxM - t2, maxM - t1 });
+            }
+        }
+    }
+    
+    vector<int> essential;
+    for (int t = 0; t < numTimes; ++t) {
+        if (!redundant[t]) essential.push_back(t);
+    }
+    return essential;
+}
+
+// Essential times by ascending support (ties by bit index): the order of
+// the compact time index, so the most constraining times come first
+vector<int> orderTimesBySupport(const vector<int>& candidates, const vector<bitset<maxM>>& nearZero,
+                                const vector<int>& essentialTimes) {
+    vector<int> support(maxM, 0);
+    for (int v : candidates) {
+        for (int t : essentialTimes) support[t] += nearZero[v][t];
+    }
+    vector<int> order = essentialTimes;
+    stable_sort(order.begin(), order.end(), [&](int a, int b) { return support[a] < support[b]; });
+    return order;
+}
+
+
+// Equivalence classes: candidates with identical cover over the essential
+// times and identical divisibility signature are interchangeable. Returns
+// index lists into candidates (ascending, first = representative), ordered
+// by representative. Keeps multiplicities, unlike dominance removal.
+vector<vector<int>> groupEquivalentCandidates(const vector<int>& candidates,
+                                              const vector<bitset<maxM>>& nearZero,
+                                              const vector<int>& essentialTimes,
+                                              const vector<int>& primeDivisors) {
+    bitset<maxM> essentialMask;
+    for (int t : essentialTimes) essentialMask[t] = true;
+
+    unordered_map<bitset<maxM>, vector<int>> byCover;
+    for (int j = 0; j < (int)candidates.size(); ++j) {
+        byCover[nearZero[candidates[j]] & essentialMask].push_back(j);
+    }
+
+    vector<vector<int>> classes;
+    for (auto& [cover, members] : byCover) {
+        map<int, vector<int>> bySignature;
+        for (int j : members) {
+            int sig = 0;
+            for (int d = 0; d < (int)primeDivisors.size(); ++d) {
+                if (candidates[j] % primeDivisors[d] == 0) sig |= 1 << d;
+            }
+            bySignature[sig].push_back(j);
+        }
+        for (auto& [sig, cls] : bySignature) classes.push_back(cls);
+    }
+    sort(classes.begin(), classes.end());
+    return classes;
+}
+
+// Peak resident set size of this process in MB, for the scaling harness
+double peakRssMB() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+    return usage.ru_maxrss / (1024.0 * 1024.0);   // bytes on macOS
+#else
+    return usage.ru_maxrss / 1024.0;              // KB on Linux
+#endif
+}
+
+// "Memory:" line read by bench_scaling.sh; leaves the stream's format as found
+void reportPeakRss(ostream& out) {
+    ios::fmtflags flags = out.flags();
+    streamsize precision = out.precision();
+    out << "Memory: peak RSS " << fixed << setprecision(1) << peakRssMB() << " MB\n";
+    out.flags(flags);
+    out.precision(precision);
+}
@@ -0,0 +1,470 @@
+// Parallel memetic local search for satisfiable Lonely Runner instances
+//
+// Walkers move through k-subsets of the reduced candidates that respect the
+// GCD limits. A move swaps one chosen velocity for an unchosen one that
+// covers a random uncovered essential time; the swap with the best weighted
+// gain wins, and recently removed velocities are tabu for a few steps. When
+// no swap gains, the weights of the uncovered times go up, so persistent
+// holes pull harder (clause weighting). A walker that has not improved its
+// best set for --stagnation steps offers that set to a shared elite pool and
+// restarts, either by path relinking between two elite sets (swapping
+// members of one for members of the other, best intermediate kept) or by
+// perturbing its own best. The pool keeps its members at least
+// --min-distance swaps apart; a close newcomer replaces its neighbour only
+// if it is better, so the pool does not collapse onto one basin.
+//
+// Incomplete: prints "s SATISFIABLE" with a witness (checked against every
+// time in [1..maxM]) or "s UNKNOWN" when --seconds runs out.
+//
+// g++ -O3 -march=native -pthread -DK=8 -DPRIME=31 -o sls src/lonely_local_search.cpp
+// ./sls [--threads N] [--seconds S] [--pool P] [--seed X]
+
+#include "lonely_common.hpp"
+#include <atomic>
+#include <mutex>
+#include <random>
+#include <thread>
+
+struct Instance {
+    vector<int> candidates;
+    vector<uint32_t> sig;                // bit d: divisible by primeDivisors[d]
+    vector<vector<int>> coverList;       // per candidate: local essential times
+    vector<vector<int>> coverers;        // per local time: candidates
+    int numTimes = 0;
+    int numDivisors = 0;
+    int limit = max(0, k - 2);
+};
+
+// Elite k-sets (sorted candidate indices) by uncovered count, kept apart
+class ElitePool {
+public:
+    ElitePool(int capacity, int minDistance) : capacity(capacity), minDistance(minDistance) {}
+
+    static int distance(const vector<int>& a, const vector<int>& b) {
+        int common = 0;
+        for (size_t i = 0, j = 0; i < a.size() && j < b.size();) {
+            if (a[i] == b[j]) ++common, ++i, ++j;
+            else if (a[i] < b[j]) ++i;
+            else ++j;
+        }
+        return (int)a.size() - common;
+    }
+
+    void offer(const vector<int>& set, int cost) {
+        lock_guard<mutex> lock(m);
+        for (auto& e : elite) {
+            if (distance(e.first, set) < minDistance) {
+                if (cost < e.second) e = { set, cost };
+                return;
+            }
+        }
+        if ((int)elite.size() < capacity) {
+            elite.push_back({ set, cost });
+            return;
+        }
+        auto worst = max_element(elite.begin(), elite.end(),
+                                 [](const auto& a, const auto& b) { return a.second < b.second; });
+        if (cost < worst->second) *worst = { set, cost };
+    }
+
+    // Two distinct members, or false while the pool is too small
+    bool pickPair(mt19937_64& rng, vector<int>& a, vector<int>& b) {
+        lock_guard<mutex> lock(m);
+        if (elite.size() < 2) return false;
+        uniform_int_distribution<size_t> pick(0, elite.size() - 1);
+        size_t i = pick(rng), j = pick(rng);
+        while (j == i) j = pick(rng);
+        a = elite[i].first;
+        b = elite[j].first;
+        return true;
+    }
+
+    size_t size() {
+        lock_guard<mutex> lock(m);
+        return elite.size();
+    }
+
+    int best() {
+        lock_guard<mutex> lock(m);
+        int c = INT32_MAX;
+        for (auto& e : elite) c = min(c, e.second);
+        return c;
+    }
+
+private:
+    int capacity, minDistance;
+    mutex m;
+    vector<pair<vector<int>, int>> elite;
+};
+
+struct Walker {
+    const Instance& in;
+    mt19937_64 rng;
+    vector<int> members;                 // chosen candidates
+    vector<char> chosen;
+    vector<int> coverCount, weight;
+    vector<int> uncovered, uncoveredPos;
+    vector<int> classCount;
+    vector<long long> tabuUntil;
+    long long steps = 0;
+    int tenure = 0;
+
+    Walker(const Instance& in, uint64_t seed)
+        : in(in), rng(seed), chosen(in.candidates.size(), 0), coverCount(in.numTimes, 0),
+          weight(in.numTimes, 1), uncoveredPos(in.numTimes, -1), classCount(in.numDivisors, 0),
+          tabuUntil(in.candidates.size(), 0) {
+        tenure = max(2, k / 2);
+        for (int t = 0; t < in.numTimes; ++t) addUncovered(t);
+    }
+
+    void addUncovered(int t) {
+        uncoveredPos[t] = (int)uncovered.size();
+        uncovered.push_back(t);
+    }
+
+    void removeUncovered(int t) {
+        int last = uncovered.back();
+        uncovered[uncoveredPos[t]] = last;
+        uncoveredPos[last] = uncoveredPos[t];
+        uncovered.pop_back();
+        uncoveredPos[t] = -1;
+    }
+
+    bool fitsAfterSwap(int out, int add) const {
+        for (int d = 0; d < in.numDivisors; ++d) {
+            int c = classCount[d] - (out >= 0 ? (int)(in.sig[out] >> d & 1) : 0) + (int)(in.sig[add] >> d & 1);
+            if (c > in.limit) return false;
+        }
+        return true;
+    }
+
+    void add(int j) {
+        chosen[j] = 1;
+        members.push_back(j);
+        for (int d = 0; d < in.numDivisors; ++d) classCount[d] += in.sig[j] >> d & 1;
+        for (int t : in.coverList[j]) {
+            if (coverCount[t]++ == 0) removeUncovered(t);
+        }
+    }
+
+    void remove(int j) {
+        chosen[j] = 0;
+        members.erase(find(members.begin(), members.end(), j));
+        for (int d = 0; d < in.numDivisors; ++d) classCount[d] -= in.sig[j] >> d & 1;
+        for (int t : in.coverList[j]) {
+            if (--coverCount[t] == 0) addUncovered(t);
+        }
+    }
+
+    void clear() {
+        while (!members.empty()) remove(members.back());
+    }
+
+    // Load a k-set; missing slots are filled greedily by coverage
+    void load(const vector<int>& set) {
+        clear();
+        for (int j : set) {
+            if (fitsAfterSwap(-1, j)) add(j);
+        }
+        fillGreedy();
+    }
+
+    // Fill to k with the best-covering fitting candidate among a few samples
+    void fillGreedy() {
+        uniform_int_distribution<int> pick(0, (int)in.candidates.size() - 1);
+        while ((int)members.size() < k) {
+            int best = -1, bestGain = -1;
+            for (int s = 0; s < 32; ++s) {
+                int j = pick(rng);
+                if (chosen[j] || !fitsAfterSwap(-1, j)) continue;
+                int gain = 0;
+                for (int t : in.coverList[j]) gain += coverCount[t] == 0;
+                if (gain > bestGain) {
+                    bestGain = gain;
+                    best = j;
+                }
+            }
+            if (best < 0) {
+                // Scan in order: some velocity divisible by no q always fits
+                for (int j = 0; j < (int)in.candidates.size() && best < 0; ++j) {
+                    if (!chosen[j] && fitsAfterSwap(-1, j)) best = j;
+                }
+            }
+            add(best);
+        }
+    }
+
+    vector<int> sortedSet() const {
+        vector<int> s = members;
+        sort(s.begin(), s.end());
+        return s;
+    }
+
+    // One weighted swap toward covering a random uncovered time
+    void step() {
+        ++steps;
+        int t = uncovered[uniform_int_distribution<int>(0, (int)uncovered.size() - 1)(rng)];
+
+        // Loss of removing each member: weight of the times only it covers
+        vector<int> loss(members.size(), 0);
+        for (size_t i = 0; i < members.size(); ++i) {
+            for (int u : in.coverList[members[i]]) {
+                if (coverCount[u] == 1) loss[i] += weight[u];
+            }
+        }
+
+        int bestDelta = INT32_MIN, bestIn = -1, bestOut = -1, ties = 0;
+        for (int b : in.coverers[t]) {
+            if (chosen[b] || tabuUntil[b] > steps) continue;
+            int gain = 0;
+            for (int u : in.coverList[b]) {
+                if (coverCount[u] == 0) gain += weight[u];
+            }
+            for (size_t i = 0; i < members.size(); ++i) {
+                int a = members[i];
+                if (!fitsAfterSwap(a, b)) continue;
+                // Times only a covered that b keeps covered
+                int kept = 0;
+                for (int u : in.coverList[a]) {
+                    if (coverCount[u] == 1 && binary_search(in.coverList[b].begin(), in.coverList[b].end(), u)) {
+                        kept += weight[u];
+                    }
+                }
+                int delta = gain + kept - loss[i];
+                if (delta > bestDelta) {
+                    bestDelta = delta;
+                    bestIn = b;
+                    bestOut = a;
+                    ties = 1;
+                } else if (delta == bestDelta && uniform_int_distribution<int>(0, ties++)(rng) == 0) {
+                    bestIn = b;
+                    bestOut = a;
+                }
+            }
+        }
+        if (bestIn < 0) {
+            for (int u : uncovered) ++weight[u];
+            return;
+        }
+        if (bestDelta <= 0) {
+            for (int u : uncovered) ++weight[u];
+        }
+        remove(bestOut);
+        add(bestIn);
+        tabuUntil[bestOut] = steps + tenure + uniform_int_distribution<int>(0, tenure)(rng);
+    }
+
+    // Walk from a toward b one swap at a time, best swap first; returns the
+    // best intermediate set other than a itself
+    vector<int> relink(const vector<int>& a, const vector<int>& b) {
+        load(a);
+        vector<int> best;
+        int bestCost = INT32_MAX;
+        for (;;) {
+            vector<int> outs, ins;
+            for (int j : members) {
+                if (!binary_search(b.begin(), b.end(), j)) outs.push_back(j);
+            }
+            for (int j : b) {
+                if (!chosen[j]) ins.push_back(j);
+            }
+            if (outs.size() <= 1) break;
+            int pickOut = -1, pickIn = -1, pickCost = INT32_MAX;
+            for (int o : outs) {
+                for (int i : ins) {
+                    if (!fitsAfterSwap(o, i)) continue;
+                    remove(o);
+                    add(i);
+                    int cost = (int)uncovered.size();
+                    remove(i);
+                    add(o);
+                    if (cost < pickCost) {
+                        pickCost = cost;
+                        pickOut = o;
+                        pickIn = i;
+                    }
+                }
+            }
+            if (pickOut < 0) break;
+            remove(pickOut);
+            add(pickIn);
+            if (pickCost < bestCost) {
+                bestCost = pickCost;
+                best = sortedSet();
+            }
+        }
+        return best.empty() ? sortedSet() : best;
+    }
+
+    // r random fitting swaps
+    void perturb(int r) {
+        uniform_int_distribution<int> pick(0, (int)in.candidates.size() - 1);
+        for (int i = 0; i < r; ++i) {
+            int a = members[uniform_int_distribution<int>(0, (int)members.size() - 1)(rng)];
+            for (int tries = 0; tries < 64; ++tries) {
+                int b = pick(rng);
+                if (chosen[b] || !fitsAfterSwap(a, b)) continue;
+                remove(a);
+                add(b);
+                break;
+            }
+        }
+    }
+};
+
+bool coversAllTimes(const vector<int>& velocities, const vector<bitset<maxM>>& nearZero,
+                    const vector<int>& primeDivisors) {
+    bitset<maxM> covered;
+    for (int v : velocities) covered |= nearZero[v];
+    for (int q : primeDivisors) {
+        if (count_if(velocities.begin(), velocities.end(), [&](int v) { return v % q == 0; }) > max(0, k - 2)) {
+            return false;
+        }
+    }
+    return covered.all();
+}
+
+int main(int argc, char** argv) {
+    ios::sync_with_stdio(false);
+
+    cerr << "k = " << k << ", n = " << n
+         << ", prime = " << prime
+         << ", Q = " << Q
+         << ", maxM = " << maxM << "\n";
+
+    int threads = 1;
+    double seconds = 60;
+    int poolSize = 16;
+    int minDistance = 2;
+    long long stagnation = 20000;
+    uint64_t seed = 1;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--threads" && i + 1 < argc) threads = max(1, atoi(argv[++i]));
+        if (arg == "--seconds" && i + 1 < argc) seconds = atof(argv[++i]);
+        if (arg == "--pool" && i + 1 < argc) poolSize = max(2, atoi(argv[++i]));
+        if (arg == "--min-distance" && i + 1 < argc) minDistance = max(1, atoi(argv[++i]));
+        if (arg == "--stagnation" && i + 1 < argc) stagnation = max(1LL, atoll(argv[++i]));
+        if (arg == "--seed" && i + 1 < argc) seed = strtoull(argv[++i], nullptr, 10);
+    }
+
+    vector<bitset<maxM>> nearZero = buildNearZero();
+    auto t_start = chrono::high_resolution_clock::now();
+
+    vector<int> primeDivisors = getPrimeDivisors(n);
+    vector<int> candidates = reduceCandidatesByDominance(initialCandidates(), nearZero, primeDivisors);
+    vector<int> essentialTimes = reduceTimesByDominance(buildCoverageSets(candidates, nearZero));
+    cerr << "Reduced instance: " << candidates.size() << " candidates, " << essentialTimes.size() << " times\n";
+
+    Instance in;
+    in.candidates = candidates;
+    in.numTimes = (int)essentialTimes.size();
+    in.numDivisors = (int)primeDivisors.size();
+    in.coverList.assign(candidates.size(), {});
+    in.coverers.assign(in.numTimes, {});
+    for (int j = 0; j < (int)candidates.size(); ++j) {
+        uint32_t s = 0;
+        for (int d = 0; d < in.numDivisors; ++d) s |= (uint32_t)(candidates[j] % primeDivisors[d] == 0) << d;
+        in.sig.push_back(s);
+        for (int i = 0; i < in.numTimes; ++i) {
+            if (nearZero[candidates[j]][essentialTimes[i]]) {
+                in.coverList[j].push_back(i);
+                in.coverers[i].push_back(j);
+            }
+        }
+    }
+    for (int i = 0; i < in.numTimes; ++i) {
+        if (in.coverers[i].empty()) {
+            cerr << "Uncoverable time t=" << maxM - essentialTimes[i] << "\n";
+            cout << "s UNSATISFIABLE\n";
+            return 0;
+        }
+    }
+
+    ElitePool pool(poolSize, minDistance);
+    atomic<bool> done{ false };
+    mutex resultLock;
+    vector<int> witness;
+    vector<long long> steps(threads, 0), restarts(threads, 0), relinks(threads, 0);
+    auto deadline = t_start + chrono::duration<double>(seconds);
+
+    vector<thread> running;
+    for (int w = 0; w < threads; ++w) {
+        running.emplace_back([&, w] {
+            Walker walker(in, seed * 0x9e3779b97f4a7c15ULL + w);
+            walker.fillGreedy();
+            vector<int> best = walker.sortedSet();
+            int bestCost = (int)walker.uncovered.size();
+            long long lastImprovement = 0;
+            while (!done.load(memory_order_relaxed)) {
+                if (walker.uncovered.empty()) {
+                    lock_guard<mutex> lock(resultLock);
+                    if (witness.empty()) {
+                        for (int j : walker.members) witness.push_back(in.candidates[j]);
+                    }
+                    done = true;
+                    break;
+                }
+                walker.step();
+                int cost = (int)walker.uncovered.size();
+                if (cost < bestCost) {
+                    bestCost = cost;
+                    best = walker.sortedSet();
+                    lastImprovement = walker.steps;
+                }
+                if (walker.steps - lastImprovement < stagnation) continue;
+
+                // Stagnated: share the best set, restart from the pool
+                pool.offer(best, bestCost);
+                vector<int> a, b;
+                if (pool.pickPair(walker.rng, a, b) && uniform_int_distribution<int>(0, 1)(walker.rng)) {
+                    walker.load(walker.relink(a, b));
+                    ++relinks[w];
+                } else {
+                    walker.load(best);
+                    walker.perturb(max(1, k / 2));
+                }
+                ++restarts[w];
+                best = walker.sortedSet();
+                bestCost = (int)walker.uncovered.size();
+                lastImprovement = walker.steps;
+                fill(walker.weight.begin(), walker.weight.end(), 1);
+            }
+            steps[w] = walker.steps;
+        });
+    }
+    // Deadline watchdog: walkers poll `done` every step
+    while (!done.load()) {
+        this_thread::sleep_for(chrono::milliseconds(10));
+        if (chrono::high_resolution_clock::now() > deadline) done = true;
+    }
+    for (auto& t : running) t.join();
+    double elapsed = chrono::duration<double>(chrono::high_resolution_clock::now() - t_start).count();
+
+    long long totalSteps = 0, totalRestarts = 0, totalRelinks = 0;
+    for (int w = 0; w < threads; ++w) {
+        totalSteps += steps[w];
+        totalRestarts += restarts[w];
+        totalRelinks += relinks[w];
+    }
+    cerr << "Local search: " << threads << " walkers, " << totalSteps << " steps ("
+         << (long long)(totalSteps / max(elapsed, 1e-9)) << "/s), " << totalRestarts << " restarts ("
+         << totalRelinks << " relinked), elite pool " << pool.size() << ", " << elapsed << "s\n";
+    reportPeakRss(cerr);
+
+    if (!witness.empty()) {
+        sort(witness.begin(), witness.end());
+        if (!coversAllTimes(witness, nearZero, primeDivisors)) {
+            cerr << "Witness failed the full check\n";
+            cout << "s UNKNOWN\n";
+            return 1;
+        }
+        cout << "s SATISFIABLE\nv";
+        for (int v : witness) cout << " " << v;
+        cout << " 0\n";
+    } else {
+        cerr << "Best elite set misses " << pool.best() << " times\n";
+        cout << "s UNKNOWN\n";
+    }
+    return 0;
+}
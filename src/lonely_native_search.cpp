@@ -0,0 +1,1318 @@
+// Native covering search for Lonely Runner Conjecture verification
+// Rosenfeld-style backtracking: branch on the least-covered uncovered time,
+// try every remaining candidate that covers it, exclude it on the way back.
+// Per-time support counts are maintained incrementally in a bucket queue;
+// candidates are scored against U in one bit-sliced pass for value ordering
+// and the coverage-sum bound. Interchangeable candidates are collapsed into
+// equivalence classes: the search branches on classes, and multiplicities
+// only enter when padding or counting (--count gives the exact number of
+// coverings; it skips velocity dominance, which drops coverings). --cert FILE writes the dominance removals and a refutation
+// split over the orbits of the ±unit group, checked by lonely_cert_check.cpp.
+// --profile FILE records
+// per-depth nodes, branching and the rule behind every pruned subtree.
+// --threads N runs N workers on a shared queue; a worker whose task has run
+// for --split-nodes nodes while another is idle donates the unexplored
+// siblings at its shallowest open branch as new tasks. --lagrange adds a
+// warm-started Lagrangian (weighted coverage-sum) bound and orders branches
+// by the resulting weights. --table keeps refuted residual instances, keyed
+// canonically under the ±unit group, in a table shared by all workers; a
+// node is cut when a refuted instance subsumes it. --branch RULE picks the
+// branching time (branch_heuristics.hpp). --plan lets the preprocessing
+// planner skip or cut dominance passes that are unlikely to pay off.
+// --components splits U into parts with disjoint candidate supports and
+// combines their cover sizes and GCD usage by a budget DP.
+// --downward first tries node-bounded searches for coverings by k-2 and
+// k-1 velocities, padded to k: a quick SAT test for instances with slack.
+//
+// Same preprocessing as the CNF generator; prints a DIMACS-style verdict:
+//   s SATISFIABLE / v <velocities> 0    (a covering exists)
+//   s UNSATISFIABLE                     (no covering, lemma applies)
+//
+// David H. Silver, 2025
+// Based on Matthieu Rosenfeld's verification approach (arXiv:2509.14111)
+
+#include "lonely_common.hpp"
+#include "uncovered_set.hpp"
+#include "support_queue.hpp"
+#include "cover_scoring.hpp"
+#include "symmetry.hpp"
+#include "search_profile.hpp"
+#include "work_queue.hpp"
+#include "residual_table.hpp"
+#include "branch_heuristics.hpp"
+#include "preprocess_planner.hpp"
+#include <climits>
+#include <cmath>
+#include <fstream>
+#include <thread>
+
+typedef unsigned __int128 u128;
+
+string toString(u128 x) {
+    string s;
+    do { s += char('0' + (int)(x % 10)); x /= 10; } while (x);
+    return string(s.rbegin(), s.rend());
+}
+
+u128 binomial(int a, int b) {
+    if (b < 0 || b > a) return 0;
+    u128 r = 1;
+    for (int i = 1; i <= b; ++i) r = r * (a - b + i) / i;
+    return r;
+}
+
+// Subproblem for a parallel worker: candidate indices to choose (in order)
+// and to exclude, as they stood at the donating branch
+struct SplitTask {
+    vector<int> chosen;
+    vector<int> excluded;
+};
+
+// Open branch node: candidates in branch order, next to try and end
+struct BranchFrame {
+    int depth;
+    vector<int> cands;
+    size_t next;
+    size_t end;
+    bool donated = false;   // siblings handed to other workers: subtree incomplete
+};
+
+struct NativeSearch {
+    int numCand = 0;
+    int candWords = 0;
+    vector<int> candidates;             // class representatives
+    vector<vector<int>> members;        // members[j]: velocities of class j
+    int numTimes = 0;
+    vector<int> timeBit;                // timeBit[t]: bit index of compact time t
+    vector<vector<uint64_t>> rows;      // rows[j]: times covered by candidate j
+    vector<vector<uint64_t>> coverOf;   // coverOf[t]: candidates covering time t
+    vector<vector<int>> coverList;      // coverList[j]: times covered by j
+    vector<uint32_t> multipleMask;      // bit d: candidate divisible by primeDivisors[d]
+    vector<int> primeDivisors;
+    int gcdLimit = max(0, k - 2);
+
+    UncoveredSet U;
+    SupportQueue queue;
+    CoverScorer scorer;
+    vector<int> coveredTrail;           // times taken off the queue by choose()
+    vector<uint64_t> available;
+    vector<int> chosen;
+    vector<int> classCount;
+    vector<int> solution;
+    int slots = k;                      // covering candidates searched for; leaf() pads to k
+    long long nodes = 0;
+    long long nodeLimit = 0;            // 0: unbounded
+    bool overLimit = false;
+    long long boundPrunes = 0;
+    long long lagrangePrunes = 0;
+    bool lagrange = false;
+    int lagrangeIters = 10;
+    int lagrangeMinRemaining = 2;
+    vector<double> lambda;              // per-time weights, kept across nodes
+    vector<int> localIndex;
+    vector<int> lagTimes, lagStart, lagCover, lagOrder, lagHits;
+    vector<double> lagLambda, lagWeight;
+    BranchRule branchRule = BranchSupport;
+    vector<double> failures;            // wdeg: dead ends at each time
+    vector<double> entropyWeights;
+    bool counting = false;
+    u128 coverings = 0;
+    ostream* proof = nullptr;           // refutation tree, preorder
+    SearchProfile profile;
+
+    WorkQueue<SplitTask>* pool = nullptr;
+    long long splitNodes = 20000;       // task nodes before donating to idle workers
+    long long taskStart = 0;
+    vector<int> taskExcluded;
+    vector<BranchFrame> frames;
+
+    ResidualTable* table = nullptr;
+    int tableMinRemaining = 3;
+    long long tableHits = 0;
+    vector<vector<int>> timeImage;      // timeImage[g][t]: bit of time t under unit map g
+    vector<vector<int>> classImage;     // classImage[g][j]: class j under unit map g
+    vector<int> keyTimes, keyClasses;
+    vector<uint64_t> keyImage;
+
+    bool components = false;
+    long long componentNodeLimit = 20000;  // per split attempt, then branch as usual
+    long long componentSplits = 0, componentPrunes = 0, componentAborts = 0;
+
+    NativeSearch(const vector<vector<int>>& classes, const vector<bitset<maxM>>& nearZero,
+                 const vector<int>& essentialTimes, const vector<int>& divisors)
+        : numCand((int)classes.size()), candWords(((int)classes.size() + 63) / 64),
+          members(classes), numTimes((int)essentialTimes.size()), primeDivisors(divisors),
+          U(numTimes), queue(numTimes, numCand), scorer(numCand, numTimes),
+          lambda(numTimes, 1.0), localIndex(numTimes, 0), failures(numTimes, 1.0) {
+        for (const auto& cls : members) candidates.push_back(cls[0]);
+        // Compact time index: only the essential times, least support first,
+        // so rows span fewer words and scans meet the tight times early
+        timeBit = orderTimesBySupport(candidates, nearZero, essentialTimes);
+        int timeWords = (numTimes + 63) / 64;
+        rows.assign(numCand, vector<uint64_t>(timeWords, 0));
+        coverOf.assign(numTimes, vector<uint64_t>(scorer.strideWords(), 0));
+        coverList.assign(numCand, {});
+        for (int j = 0; j < numCand; ++j) {
+            for (int t = 0; t < numTimes; ++t) {
+                if (!nearZero[candidates[j]][timeBit[t]]) continue;
+                rows[j][t >> 6] |= 1ULL << (t & 63);
+                coverOf[t][j >> 6] |= 1ULL << (j & 63);
+                coverList[j].push_back(t);
+            }
+        }
+
+        multipleMask.assign(numCand, 0);
+        for (int j = 0; j < numCand; ++j) {
+            for (int d = 0; d < (int)primeDivisors.size(); ++d) {
+                if (candidates[j] % primeDivisors[d] == 0) multipleMask[j] |= 1u << d;
+            }
+        }
+        classCount.assign(primeDivisors.size(), 0);
+
+        for (int t = 0; t < numTimes; ++t) {
+            int support = 0;
+            for (int w = 0; w < candWords; ++w) support += __builtin_popcountll(coverOf[t][w]);
+            U.insert(t);
+            queue.setSupport(t, support);
+            queue.insert(t);
+        }
+        available.assign(candWords, 0);
+        for (int j = 0; j < numCand; ++j) available[j >> 6] |= 1ULL << (j & 63);
+    }
+
+    void exclude(int j) {
+        available[j >> 6] &= ~(1ULL << (j & 63));
+        for (int t : coverList[j]) queue.decrement(t);
+    }
+
+    void restore(int j) {
+        available[j >> 6] |= 1ULL << (j & 63);
+        for (int t : coverList[j]) queue.increment(t);
+    }
+
+    bool fitsGcd(int j) const {
+        for (uint32_t m = multipleMask[j]; m; m &= m - 1) {
+            if (classCount[__builtin_ctz(m)] >= gcdLimit) return false;
+        }
+        return true;
+    }
+
+    void choose(int j) {
+        chosen.push_back(j);
+        for (uint32_t m = multipleMask[j]; m; m &= m - 1) ++classCount[__builtin_ctz(m)];
+        const uint64_t* row = rows[j].data();
+        U.forEachWord([&](int w, uint64_t x) {
+            for (x &= row[w]; x; x &= x - 1) {
+                int t = (w << 6) | __builtin_ctzll(x);
+                queue.erase(t);
+                coveredTrail.push_back(t);
+            }
+        });
+        U.subtract(row);
+    }
+
+    void unchoose(int j, size_t mark, size_t coveredMark) {
+        U.undo(mark);
+        while (coveredTrail.size() > coveredMark) {
+            queue.insert(coveredTrail.back());
+            coveredTrail.pop_back();
+        }
+        for (uint32_t m = multipleMask[j]; m; m &= m - 1) --classCount[__builtin_ctz(m)];
+        chosen.pop_back();
+    }
+
+    bool isAvailable(int j) const { return available[j >> 6] >> (j & 63) & 1; }
+
+    // Velocities that may fill the remaining slots, grouped by signature:
+    // other members of chosen classes and members of available classes
+    vector<vector<int>> paddingBySignature() const {
+        vector<vector<int>> groups(1u << primeDivisors.size());
+        vector<char> used(numCand, 0);
+        for (int j : chosen) used[j] = 1;
+        for (int j = 0; j < numCand; ++j) {
+            if (!used[j] && !isAvailable(j)) continue;
+            for (int i = used[j] ? 1 : 0; i < (int)members[j].size(); ++i) {
+                groups[multipleMask[j]].push_back(members[j][i]);
+            }
+        }
+        return groups;
+    }
+
+    // Everything covered: fill the remaining slots within the GCD limits
+    bool pad() {
+        auto groups = paddingBySignature();
+        vector<int> take(groups.size(), 0);
+        vector<int> budget(primeDivisors.size());
+        for (int d = 0; d < (int)budget.size(); ++d) budget[d] = gcdLimit - classCount[d];
+
+        function<bool(int, int)> fill = [&](int sig, int left) {
+            if (sig == (int)groups.size()) return left == 0;
+            int most = min(left, (int)groups[sig].size());
+            for (int d = 0; d < (int)budget.size(); ++d) {
+                if (sig >> d & 1) most = min(most, budget[d]);
+            }
+            for (int c = most; c >= 0; --c) {
+                for (int d = 0; d < (int)budget.size(); ++d) if (sig >> d & 1) budget[d] -= c;
+                take[sig] = c;
+                bool ok = fill(sig + 1, left - c);
+                for (int d = 0; d < (int)budget.size(); ++d) if (sig >> d & 1) budget[d] += c;
+                if (ok) return true;
+            }
+            return false;
+        };
+        if (!fill(0, k - (int)chosen.size())) return false;
+
+        solution.clear();
+        for (int j : chosen) solution.push_back(candidates[j]);
+        for (int sig = 0; sig < (int)groups.size(); ++sig) {
+            for (int i = 0; i < take[sig]; ++i) solution.push_back(groups[sig][i]);
+        }
+        sort(solution.begin(), solution.end());
+        return true;
+    }
+
+    // Number of k-sets extending chosen once U is empty: each chosen class
+    // contributes C(m, 1 + extra), available velocities C(g, c) per
+    // signature, subject to the remaining slots and GCD budgets
+    u128 countCompletions() {
+        int r = k - (int)chosen.size();
+        int P = (int)primeDivisors.size();
+        vector<int> budget(P), mult(P);
+        int size = r + 1;
+        for (int d = 0; d < P; ++d) {
+            budget[d] = gcdLimit - classCount[d];
+            mult[d] = size;
+            size *= budget[d] + 1;
+        }
+
+        vector<u128> dp(size, 0), next;
+        dp[0] = 1;
+        // Take c = 0..weights.size()-1 velocities of signature sig
+        auto take = [&](uint32_t sig, const vector<u128>& weights) {
+            next.assign(size, 0);
+            for (int s = 0; s < size; ++s) {
+                if (!dp[s]) continue;
+                int used = s % (r + 1);
+                for (int c = 0; c < (int)weights.size() && used + c <= r; ++c) {
+                    int idx = s + c;
+                    bool ok = true;
+                    for (int d = 0; d < P && ok; ++d) {
+                        if (!(sig >> d & 1)) continue;
+                        int b = s / mult[d] % (budget[d] + 1);
+                        ok = b + c <= budget[d];
+                        idx += c * mult[d];
+                    }
+                    if (!ok) break;
+                    next[idx] += dp[s] * weights[c];
+                }
+            }
+            dp.swap(next);
+        };
+
+        for (int j : chosen) {
+            int m = (int)members[j].size();
+            vector<u128> weights(m);
+            for (int e = 0; e < m; ++e) weights[e] = binomial(m, 1 + e);
+            take(multipleMask[j], weights);
+        }
+        vector<int> groupSize(1u << P, 0);
+        vector<char> used(numCand, 0);
+        for (int j : chosen) used[j] = 1;
+        for (int j = 0; j < numCand; ++j) {
+            if (!used[j] && isAvailable(j)) groupSize[multipleMask[j]] += (int)members[j].size();
+        }
+        for (uint32_t sig = 0; sig < groupSize.size(); ++sig) {
+            vector<u128> weights(min(groupSize[sig], r) + 1);
+            for (int c = 0; c < (int)weights.size(); ++c) weights[c] = binomial(groupSize[sig], c);
+            take(sig, weights);
+        }
+
+        u128 total = 0;
+        for (int s = 0; s < size; ++s) {
+            if (s % (r + 1) == r) total += dp[s];
+        }
+        return total;
+    }
+
+    // U is empty: find a witness, or add this subtree's coverings
+    bool leaf() {
+        if (!counting) return pad();
+        u128 c = countCompletions();
+        if (c && solution.empty()) pad();
+        coverings += c;
+        return false;
+    }
+
+    // Uncovered time with the fewest available candidates; -1 if U is empty
+    int leastCoveredTime(int& support) {
+        int t = queue.minTime();
+        support = t < 0 ? 0 : queue.supportOf(t);
+        return t;
+    }
+
+    // Give the unexplored siblings of the shallowest open branch to the queue
+    void donate() {
+        for (BranchFrame& f : frames) {
+            if (f.next >= f.end) continue;
+            SplitTask base;
+            base.chosen.assign(chosen.begin(), chosen.begin() + f.depth);
+            base.excluded = taskExcluded;
+            for (const BranchFrame& g : frames) {
+                if (&g == &f) break;
+                base.excluded.insert(base.excluded.end(), g.cands.begin(), g.cands.begin() + (g.next - 1));
+            }
+            base.excluded.insert(base.excluded.end(), f.cands.begin(), f.cands.begin() + f.next);
+            for (size_t i = f.next; i < f.end; ++i) {
+                SplitTask task = base;
+                task.chosen.push_back(f.cands[i]);
+                pool->push(move(task));
+                base.excluded.push_back(f.cands[i]);
+            }
+            f.end = f.next;
+            for (BranchFrame& g : frames) {
+                g.donated = true;
+                if (&g == &f) break;
+            }
+            break;
+        }
+        taskStart = nodes;
+    }
+
+    // Replay a task's choices and exclusions, search it, and undo them
+    bool runTask(const SplitTask& task) {
+        taskExcluded = task.excluded;
+        for (int j : task.excluded) exclude(j);
+        vector<pair<size_t, size_t>> marks;
+        for (int j : task.chosen) {
+            marks.push_back({ U.mark(), coveredTrail.size() });
+            choose(j);
+        }
+        taskStart = nodes;
+        bool found = search();
+        for (size_t i = task.chosen.size(); i-- > 0;) unchoose(task.chosen[i], marks[i].first, marks[i].second);
+        for (int j : task.excluded) restore(j);
+        return found;
+    }
+
+    // Unit maps u that send every class onto a class of the same size
+    // (times go to t/u); canonical residual keys minimize over these
+    void setSymmetry(const vector<int>& units) {
+        vector<int> classOf(maxM + 1, -1);
+        for (int j = 0; j < numCand; ++j) {
+            for (int v : members[j]) classOf[v] = j;
+        }
+        timeImage.clear();
+        classImage.clear();
+        for (int u : units) {
+            vector<int> cls(numCand);
+            bool ok = true;
+            for (int j = 0; j < numCand && ok; ++j) {
+                cls[j] = classOf[foldMod((long long)members[j][0] * u)];
+                ok = cls[j] >= 0 && members[cls[j]].size() == members[j].size();
+                for (int v : members[j]) ok = ok && classOf[foldMod((long long)v * u)] == cls[j];
+            }
+            if (!ok) continue;
+            int inverse = unitInverse(u);
+            vector<int> times(numTimes);
+            for (int t = 0; t < numTimes; ++t) times[t] = maxM - foldMod((long long)(maxM - timeBit[t]) * inverse);
+            timeImage.push_back(move(times));
+            classImage.push_back(move(cls));
+        }
+    }
+
+    // Canonical form of the residual below this node. key: remaining
+    // slots, GCD counts and U, minimized over the unit maps. images, one per
+    // minimizing map: padding supply per signature in unary (capped at the
+    // remaining slots) and the available classes touching U, as bit rows.
+    // Fewer classes or less supply is a subset, and a harder instance.
+    // Classes that miss U can only pad; the subtree never chooses or
+    // excludes them. Uses the node's scores.
+    void residualKey(vector<uint64_t>& key, vector<vector<uint64_t>>& images) {
+        int remaining = k - (int)chosen.size();
+        vector<int> supply(1u << primeDivisors.size(), 0);
+        for (int j : chosen) supply[multipleMask[j]] += (int)members[j].size() - 1;
+        keyClasses.clear();
+        for (int w = 0; w < candWords; ++w) {
+            for (uint64_t x = available[w]; x; x &= x - 1) {
+                int j = (w << 6) | __builtin_ctzll(x);
+                if (scorer.count(j) > 0) keyClasses.push_back(j);
+                else supply[multipleMask[j]] += (int)members[j].size();
+            }
+        }
+        uint64_t supplyBits = 0;
+        for (size_t sig = 0; sig < supply.size(); ++sig) {
+            supplyBits |= ((1ULL << min(supply[sig], remaining)) - 1) << (16 * sig);
+        }
+        keyTimes.clear();
+        U.forEach([&](int t) { keyTimes.push_back(t); });
+
+        key.assign(1, remaining);
+        for (int c : classCount) key.push_back(c);
+        int timeWords = (maxM + 63) / 64;
+        size_t base = key.size();
+        key.resize(base + timeWords);
+        uint64_t* best = key.data() + base;
+        vector<int> ties;
+        for (size_t g = 0; g < timeImage.size(); ++g) {
+            keyImage.assign(timeWords, 0);
+            for (int t : keyTimes) {
+                int b = timeImage[g][t];
+                keyImage[b >> 6] |= 1ULL << (b & 63);
+            }
+            int cmp = g == 0 ? -1 : 0;
+            for (int w = 0; w < timeWords && !cmp; ++w) {
+                if (keyImage[w] != best[w]) cmp = keyImage[w] < best[w] ? -1 : 1;
+            }
+            if (cmp < 0) {
+                copy(keyImage.begin(), keyImage.end(), best);
+                ties.clear();
+            }
+            if (cmp <= 0) ties.push_back((int)g);
+        }
+
+        images.assign(ties.size(), vector<uint64_t>(1 + candWords, 0));
+        for (size_t i = 0; i < ties.size(); ++i) {
+            images[i][0] = supplyBits;
+            for (int j : keyClasses) {
+                int c = classImage[ties[i]][j];
+                images[i][1 + (c >> 6)] |= 1ULL << (c & 63);
+            }
+        }
+    }
+
+    // Time to branch on under branchRule; t is the least-covered time,
+    // fitting the available candidates within the GCD limits. Needs the node's scores
+    // (and λ from lagrangeBound for the dual rule).
+    int branchTime(int t, const vector<int>& fitting) {
+        int best = t;
+        switch (branchRule) {
+        case BranchSupport:
+            break;
+        case BranchMarginal: {
+            int top = -1;
+            for (int j : fitting) {
+                if (top < 0 || scorer.count(j) > scorer.count(top)) top = j;
+            }
+            if (top < 0) break;
+            int least = INT_MAX;
+            U.forEachWord([&](int w, uint64_t x) {
+                for (x &= rows[top][w]; x; x &= x - 1) {
+                    int u = (w << 6) | __builtin_ctzll(x);
+                    if (queue.supportOf(u) < least) {
+                        least = queue.supportOf(u);
+                        best = u;
+                    }
+                }
+            });
+            break;
+        }
+        case BranchWdeg: {
+            double bestRatio = HUGE_VAL;
+            U.forEach([&](int u) {
+                double ratio = queue.supportOf(u) / failures[u];
+                if (ratio < bestRatio) {
+                    bestRatio = ratio;
+                    best = u;
+                }
+            });
+            break;
+        }
+        case BranchDual: {
+            U.forEach([&](int u) {
+                if (lambda[u] > lambda[best] ||
+                    (lambda[u] == lambda[best] && queue.supportOf(u) < queue.supportOf(best))) best = u;
+            });
+            break;
+        }
+        case BranchEntropy: {
+            int low = queue.supportOf(t);
+            double bestEntropy = 0;
+            bool any = false;
+            for (int s = low; s <= min(low + 1, queue.maxSupport()); ++s) {
+                for (int u : queue.bucket(s)) {
+                    double total = 0, h = 0;
+                    entropyWeights.clear();
+                    for (int w = 0; w < candWords; ++w) {
+                        for (uint64_t x = coverOf[u][w] & available[w]; x; x &= x - 1) {
+                            int j = (w << 6) | __builtin_ctzll(x);
+                            if (!fitsGcd(j)) continue;
+                            entropyWeights.push_back(scorer.count(j));
+                            total += scorer.count(j);
+                        }
+                    }
+                    for (double c : entropyWeights) {
+                        if (c > 0) h -= c / total * log(c / total);
+                    }
+                    if (!any || h < bestEntropy) {
+                        any = true;
+                        bestEntropy = h;
+                        best = u;
+                    }
+                }
+            }
+            break;
+        }
+        default:
+            break;
+        }
+        return best;
+    }
+
+    // Weighted coverage-sum (Lagrangian) bound. For any weights λ ≥ 0 on U,
+    // `remaining` more candidates covering U need their weights
+    // s_j = Σ λ_t over cover(j) ∩ U to add up to Σ λ_t; λ = 1 is the plain
+    // coverage-sum bound. Polyak subgradient steps shift weight onto the
+    // times the current best `remaining` candidates cover least, and λ is
+    // kept for the next node. False means prune; weight[j] = s_j under the
+    // last λ, for branch ordering.
+    bool lagrangeBound(const vector<int>& pool, int remaining, vector<double>& weight) {
+        // Residual incidence in CSR form over local time indices
+        lagTimes.clear();
+        U.forEach([&](int t) {
+            localIndex[t] = (int)lagTimes.size();
+            lagTimes.push_back(t);
+        });
+        int m = (int)lagTimes.size(), p = (int)pool.size();
+        lagStart.assign(1, 0);
+        lagCover.clear();
+        for (int j : pool) {
+            for (int t : coverList[j]) if (U.contains(t)) lagCover.push_back(localIndex[t]);
+            lagStart.push_back((int)lagCover.size());
+        }
+        lagLambda.resize(m);
+        for (int i = 0; i < m; ++i) lagLambda[i] = lambda[lagTimes[i]];
+        lagWeight.resize(p);
+        lagOrder.resize(p);
+        lagHits.resize(m);
+        int top = min(remaining, p);
+
+        bool feasible = true;
+        for (int it = 0; it < lagrangeIters; ++it) {
+            double total = 0;
+            for (double l : lagLambda) total += l;
+            if (total <= 0) {
+                fill(lagLambda.begin(), lagLambda.end(), 1.0);
+                total = m;
+            }
+            for (int i = 0; i < p; ++i) {
+                double s = 0;
+                for (int e = lagStart[i]; e < lagStart[i + 1]; ++e) s += lagLambda[lagCover[e]];
+                lagWeight[i] = s;
+                lagOrder[i] = i;
+            }
+            nth_element(lagOrder.begin(), lagOrder.begin() + top, lagOrder.end(),
+                        [&](int a, int b) { return lagWeight[a] > lagWeight[b]; });
+            double reach = 0;
+            for (int i = 0; i < top; ++i) reach += lagWeight[lagOrder[i]];
+            if (reach < total * (1 - 1e-9)) {
+                feasible = false;
+                break;
+            }
+
+            // Subgradient of Σλ - reach: 1 - (times covered by the top set)
+            fill(lagHits.begin(), lagHits.end(), 0);
+            for (int i = 0; i < top; ++i) {
+                int c = lagOrder[i];
+                for (int e = lagStart[c]; e < lagStart[c + 1]; ++e) ++lagHits[lagCover[e]];
+            }
+            double norm = 0;
+            for (int h : lagHits) norm += (double)(1 - h) * (1 - h);
+            if (norm == 0) break;
+            double step = (reach - total + 1e-3 * total) / norm;
+            for (int i = 0; i < m; ++i) lagLambda[i] = max(0.0, lagLambda[i] + step * (1 - lagHits[i]));
+        }
+
+        for (int i = 0; i < m; ++i) lambda[lagTimes[i]] = lagLambda[i];
+        for (int i = 0; i < p; ++i) weight[pool[i]] = lagWeight[i];
+        return feasible;
+    }
+
+    // One way to cover a component: size, multiples of each prime divisor
+    // and the classes used
+    struct ComponentCover {
+        int size;
+        vector<int> usage;
+        vector<int> classes;
+    };
+
+    // U splits when no candidate touches two of its parts: union-find over
+    // the uncovered times, joining the times of each touching candidate.
+    // For every part, the Pareto-minimal (size, GCD usage) covers are
+    // enumerated; a DP over the slots and GCD budgets then combines the
+    // parts instead of branching through their product. Returns 1 with a
+    // witness in solution, 0 if no combination fits (refuted), -1 if U is
+    // connected, a part ran over componentNodeLimit or no combination padded.
+    int solveComponents(const vector<int>& fitting, int remaining) {
+        vector<int> times;
+        U.forEach([&](int t) {
+            localIndex[t] = (int)times.size();
+            times.push_back(t);
+        });
+        int m = (int)times.size();
+        vector<int> parent(m);
+        for (int i = 0; i < m; ++i) parent[i] = i;
+        function<int(int)> find = [&](int x) { return parent[x] == x ? x : parent[x] = find(parent[x]); };
+        vector<int> touching;
+        for (int j : fitting) {
+            if (scorer.count(j) == 0) continue;
+            touching.push_back(j);
+            int first = -1;
+            U.forEachWord([&](int w, uint64_t x) {
+                for (x &= rows[j][w]; x; x &= x - 1) {
+                    int i = find(localIndex[(w << 6) | __builtin_ctzll(x)]);
+                    if (first < 0) first = i;
+                    else parent[i] = first;
+                }
+            });
+        }
+        vector<int> partOf(m, -1);
+        int parts = 0;
+        for (int i = 0; i < m; ++i) {
+            if (partOf[find(i)] < 0) partOf[find(i)] = parts++;
+            partOf[i] = partOf[find(i)];
+        }
+        if (parts < 2) return -1;
+        ++componentSplits;
+        if (parts > remaining) return 0;
+
+        // Local instance per part: times as bit indices, candidate rows
+        int P = (int)primeDivisors.size();
+        vector<vector<int>> partTimes(parts), partCands(parts);
+        vector<int> slot(m);
+        for (int i = 0; i < m; ++i) {
+            slot[i] = (int)partTimes[partOf[i]].size();
+            partTimes[partOf[i]].push_back(i);
+        }
+        for (int j : touching) {
+            int first = -1;
+            for (int t : coverList[j]) {
+                if (U.contains(t)) {
+                    first = localIndex[t];
+                    break;
+                }
+            }
+            partCands[partOf[first]].push_back(j);
+        }
+
+        vector<vector<ComponentCover>> frontier(parts);
+        long long budgetNodes = componentNodeLimit;
+        for (int c = 0; c < parts; ++c) {
+            int size = (int)partTimes[c].size(), words = (size + 63) / 64;
+            int cands = (int)partCands[c].size();
+            vector<vector<uint64_t>> local(cands, vector<uint64_t>(words, 0));
+            for (int a = 0; a < cands; ++a) {
+                for (int t : coverList[partCands[c][a]]) {
+                    if (!U.contains(t)) continue;
+                    int b = slot[localIndex[t]];
+                    local[a][b >> 6] |= 1ULL << (b & 63);
+                }
+            }
+            // Each other part takes at least one slot
+            int limit = remaining - (parts - 1);
+            vector<uint64_t> open(words, 0);
+            for (int b = 0; b < size; ++b) open[b >> 6] |= 1ULL << (b & 63);
+            vector<int> usage(P, 0), picked;
+            vector<char> out(cands, 0);
+            auto& points = frontier[c];
+            auto dominated = [&](int sz, const vector<int>& use) {
+                for (const auto& p : points) {
+                    bool le = p.size <= sz;
+                    for (int d = 0; d < P && le; ++d) le = p.usage[d] <= use[d];
+                    if (le) return true;
+                }
+                return false;
+            };
+            function<void()> enumerate = [&]() {
+                if (--budgetNodes < 0) return;
+                int sz = (int)picked.size();
+                if (dominated(sz, usage)) return;
+                int best = -1, bestSupport = INT_MAX;
+                for (int w = 0; w < words; ++w) {
+                    for (uint64_t x = open[w]; x; x &= x - 1) {
+                        int b = (w << 6) | __builtin_ctzll(x), support = 0;
+                        for (int a = 0; a < cands; ++a) support += !out[a] && (local[a][w] >> (b & 63) & 1);
+                        if (support < bestSupport) {
+                            bestSupport = support;
+                            best = b;
+                        }
+                    }
+                }
+                if (best < 0) {
+                    // Covered: keep it, dropping the points it dominates
+                    points.erase(remove_if(points.begin(), points.end(), [&](const ComponentCover& p) {
+                        bool ge = p.size >= sz;
+                        for (int d = 0; d < P && ge; ++d) ge = p.usage[d] >= usage[d];
+                        return ge;
+                    }), points.end());
+                    points.push_back({ sz, usage, {} });
+                    for (int a : picked) points.back().classes.push_back(partCands[c][a]);
+                    return;
+                }
+                if (sz == limit) return;
+                vector<int> tried;
+                for (int a = 0; a < cands; ++a) {
+                    if (out[a] || !(local[a][best >> 6] >> (best & 63) & 1)) continue;
+                    uint32_t mask = multipleMask[partCands[c][a]];
+                    bool fits = true;
+                    for (uint32_t x = mask; x; x &= x - 1) {
+                        int d = __builtin_ctz(x);
+                        fits = fits && classCount[d] + usage[d] < gcdLimit;
+                    }
+                    if (!fits) continue;
+                    vector<uint64_t> saved = open;
+                    for (int w = 0; w < words; ++w) open[w] &= ~local[a][w];
+                    for (uint32_t x = mask; x; x &= x - 1) ++usage[__builtin_ctz(x)];
+                    picked.push_back(a);
+                    enumerate();
+                    picked.pop_back();
+                    for (uint32_t x = mask; x; x &= x - 1) --usage[__builtin_ctz(x)];
+                    open = saved;
+                    // Later siblings need not consider a again
+                    out[a] = 1;
+                    tried.push_back(a);
+                }
+                for (int a : tried) out[a] = 0;
+            };
+            enumerate();
+            if (budgetNodes < 0) {
+                ++componentAborts;
+                return -1;
+            }
+            if (points.empty()) return 0;
+        }
+
+        // DP over (slots, usage per divisor); each state keeps one witness
+        map<vector<int>, vector<int>> states = { { vector<int>(1 + P, 0), {} } };
+        for (int c = 0; c < parts; ++c) {
+            map<vector<int>, vector<int>> next;
+            for (const auto& [state, picks] : states) {
+                for (int i = 0; i < (int)frontier[c].size(); ++i) {
+                    const auto& p = frontier[c][i];
+                    vector<int> s = state;
+                    bool ok = (s[0] += p.size) <= remaining;
+                    for (int d = 0; d < P && ok; ++d) ok = (s[1 + d] += p.usage[d]) + classCount[d] <= gcdLimit;
+                    if (!ok || next.count(s)) continue;
+                    next[s] = picks;
+                    next[s].push_back(i);
+                }
+            }
+            states.swap(next);
+        }
+        if (states.empty()) return 0;
+
+        for (const auto& [state, picks] : states) {
+            size_t base = chosen.size();
+            for (int c = 0; c < parts; ++c) {
+                for (int j : frontier[c][picks[c]].classes) {
+                    chosen.push_back(j);
+                    for (uint32_t x = multipleMask[j]; x; x &= x - 1) ++classCount[__builtin_ctz(x)];
+                }
+            }
+            bool found = pad();
+            while (chosen.size() > base) {
+                for (uint32_t x = multipleMask[chosen.back()]; x; x &= x - 1) --classCount[__builtin_ctz(x)];
+                chosen.pop_back();
+            }
+            if (found) return 1;
+        }
+        return -1;
+    }
+
+    bool search() {
+        ++nodes;
+        if (nodeLimit && nodes > nodeLimit) {
+            overLimit = true;
+            return false;
+        }
+        int depth = (int)chosen.size();
+        if (pool) {
+            if (pool->isStopped()) return false;
+            if (nodes - taskStart > splitNodes && pool->wantsWork()) donate();
+        }
+        SearchProfile::Clock::time_point start;
+        if (profile.enabled) start = profile.enter(depth);
+        // Pruned node: attribute the cut and close its timing
+        auto pruned = [&](PruneRule rule, NodeKind kind = NodePruned) {
+            if (profile.enabled) {
+                profile.prune(depth, rule);
+                profile.leave(kind, start);
+            }
+            return false;
+        };
+
+        if (U.empty()) {
+            bool found = leaf();
+            if (proof && !found) *proof << "P\n";
+            if (!found && !counting) return pruned(PruneNoPadding);
+            if (profile.enabled) profile.leave(NodeLeaf, start);
+            return found;
+        }
+        if (depth == slots) {
+            if (proof) *proof << "K\n";
+            return pruned(PruneBudget);
+        }
+
+        int support;
+        int t = leastCoveredTime(support);
+        if (support == 0) {
+            if (proof) *proof << "E " << maxM - timeBit[t] << "\n";
+            ++failures[t];
+            return pruned(PruneNoSupport);
+        }
+
+        // Last slot: a single candidate must cover all of U
+        if (depth == slots - 1) {
+            bool fits = false;
+            for (int w = 0; w < candWords; ++w) {
+                for (uint64_t x = coverOf[t][w] & available[w]; x; x &= x - 1) {
+                    int j = (w << 6) | __builtin_ctzll(x);
+                    if (!U.subsetOf(rows[j].data())) continue;
+                    if (!fitsGcd(j)) {
+                        if (profile.enabled) profile.prune(depth, PruneGcdLimit);
+                        continue;
+                    }
+                    fits = true;
+                    chosen.push_back(j);
+                    for (uint32_t m = multipleMask[j]; m; m &= m - 1) ++classCount[__builtin_ctz(m)];
+                    bool found = leaf();
+                    for (uint32_t m = multipleMask[j]; m; m &= m - 1) --classCount[__builtin_ctz(m)];
+                    chosen.pop_back();
+                    if (found) {
+                        if (profile.enabled) profile.leave(NodeLastSlot, start);
+                        return true;
+                    }
+                }
+            }
+            if (proof) *proof << "L\n";
+            if (!fits) {
+                ++failures[t];
+                return pruned(PruneLastSlot, NodeLastSlot);
+            }
+            // Covered, but every completion broke the GCD limits or padding
+            if (profile.enabled) {
+                if (!counting) profile.prune(depth, PruneNoPadding);
+                profile.leave(NodeLastSlot, start);
+            }
+            return false;
+        }
+
+        // Score every available candidate against U in one pass
+        scorer.score(U, coverOf);
+        int remaining = slots - (int)chosen.size();
+        vector<int> scores, fitting;     // available candidates within the GCD limits
+        for (int w = 0; w < candWords; ++w) {
+            for (uint64_t x = available[w]; x; x &= x - 1) {
+                int j = (w << 6) | __builtin_ctzll(x);
+                if (!fitsGcd(j)) continue;
+                fitting.push_back(j);
+                scores.push_back(scorer.count(j));
+            }
+        }
+
+        // Coverage-sum bound: the best `remaining` scores must reach |U|
+        if ((int)scores.size() > remaining) {
+            nth_element(scores.begin(), scores.begin() + remaining, scores.end(), greater<int>());
+            scores.resize(remaining);
+        }
+        int reach = 0;
+        for (int sc : scores) reach += sc;
+        if (reach < U.count()) {
+            ++boundPrunes;
+            if (proof) *proof << "S\n";
+            return pruned(PruneCoverageSum);
+        }
+
+        // Residual already refuted, or a unit image of one with at least
+        // these classes and this much padding
+        vector<uint64_t> key;
+        vector<vector<uint64_t>> images;
+        if (table && remaining >= tableMinRemaining) {
+            residualKey(key, images);
+            if (table->refutes(key, images)) {
+                ++tableHits;
+                return pruned(PruneTransposition);
+            }
+        }
+
+        // Near the leaves the plain bound already decides; the subgradient
+        // loop pays off only above subtrees of some size
+        vector<double> weight;
+        if (lagrange && remaining >= lagrangeMinRemaining) {
+            weight.assign(numCand, 0.0);
+            if (!lagrangeBound(fitting, remaining, weight)) {
+                ++lagrangePrunes;
+                return pruned(PruneLagrange);
+            }
+        }
+
+        if (components && remaining >= 2) {
+            int verdict = solveComponents(fitting, remaining);
+            if (verdict == 1) {
+                if (profile.enabled) profile.leave(NodeLeaf, start);
+                return true;
+            }
+            if (verdict == 0) {
+                ++componentPrunes;
+                if (!key.empty()) table->insert(key, images[0]);
+                return pruned(PruneComponents);
+            }
+        }
+
+        t = branchTime(t, fitting);
+        vector<pair<int, int>> branch;   // (score, candidate) covering t
+        for (int w = 0; w < candWords; ++w) {
+            for (uint64_t x = coverOf[t][w] & available[w]; x; x &= x - 1) {
+                int j = (w << 6) | __builtin_ctzll(x);
+                if (!fitsGcd(j)) {
+                    if (profile.enabled) profile.prune(depth, PruneGcdLimit);
+                    continue;
+                }
+                branch.push_back({ scorer.count(j), j });
+            }
+        }
+        if (!weight.empty()) {
+            // Most new coverage first, heavier weight among equal scores
+            sort(branch.begin(), branch.end(), [&](auto& a, auto& b) {
+                return a.first != b.first ? a.first > b.first : weight[a.second] > weight[b.second];
+            });
+        } else {
+            // Most new coverage first
+            sort(branch.begin(), branch.end(), [](auto& a, auto& b) { return a.first > b.first; });
+        }
+        if (proof) {
+            *proof << "B " << maxM - timeBit[t];
+            for (auto [sc, j] : branch) *proof << " " << candidates[j];
+            *proof << "\n";
+        }
+        if (profile.enabled) profile.leave(NodeBranch, start);
+
+        // The frame lets donate() hand the untried siblings to other workers
+        size_t fi = frames.size();
+        frames.push_back({ depth, {}, 0, branch.size() });
+        for (auto [sc, j] : branch) frames[fi].cands.push_back(j);
+
+        vector<int> excluded;
+        bool found = false;
+        while (frames[fi].next < frames[fi].end) {
+            int j = frames[fi].cands[frames[fi].next++];
+            if (profile.enabled) profile.branch(depth, 1);
+            size_t mark = U.mark();
+            size_t coveredMark = coveredTrail.size();
+            choose(j);
+            found = search();
+            unchoose(j, mark, coveredMark);
+            if (found) break;
+            // Later siblings need not consider j again
+            exclude(j);
+            excluded.push_back(j);
+        }
+        bool complete = !frames[fi].donated && !(pool && pool->isStopped());
+        frames.pop_back();
+        for (int j : excluded) restore(j);
+        if (!found && complete && !key.empty()) table->insert(key, images[0]);
+        return found;
+    }
+
+    // Covering by at most `cover` candidates, padded to k, within `limit`
+    // nodes. The coverage-sum bound is much tighter with fewer slots, so
+    // when a SAT instance has slack this finds a witness long before the
+    // exactly-k search would. Verdict-only, like the table: the table,
+    // components and profile are off for the tier.
+    bool searchDownward(int cover, long long limit) {
+        ResidualTable* savedTable = table;
+        bool savedComponents = components, savedProfile = profile.enabled;
+        table = nullptr;
+        components = false;
+        profile.enabled = false;
+        slots = cover;
+        nodeLimit = nodes + limit;
+        overLimit = false;
+        bool found = search();
+        slots = k;
+        nodeLimit = 0;
+        table = savedTable;
+        components = savedComponents;
+        profile.enabled = savedProfile;
+        return found;
+    }
+
+    // Refute orbit by orbit: case i has its smallest member chosen and every
+    // earlier orbit excluded, which covers all coverings up to symmetry
+    bool searchByOrbits(const vector<vector<int>>& orbits) {
+        vector<int> indexOf(maxM + 1, -1);
+        for (int j = 0; j < numCand; ++j) indexOf[candidates[j]] = j;
+
+        vector<int> excluded;
+        bool found = false;
+        for (const auto& orbit : orbits) {
+            int j = indexOf[orbit[0]];
+            if (proof) *proof << "r " << orbit[0] << "\n";
+            size_t mark = U.mark();
+            size_t coveredMark = coveredTrail.size();
+            choose(j);
+            found = search();
+            unchoose(j, mark, coveredMark);
+            if (found) break;
+            for (int v : orbit) {
+                exclude(indexOf[v]);
+                excluded.push_back(indexOf[v]);
+            }
+        }
+        for (int j : excluded) restore(j);
+        return found;
+    }
+};
+
+int main(int argc, char** argv) {
+    ios::sync_with_stdio(false);
+    cin.tie(nullptr);
+
+    cerr << "k = " << k << ", n = " << n
+         << ", prime = " << prime
+         << ", Q = " << Q
+         << ", maxM = " << maxM << "\n";
+
+    string certPath, profilePath;
+    bool counting = false;
+    int threads = 1;
+    long long splitNodes = 20000;
+    bool lagrange = false;
+    int lagrangeIters = 10;
+    BranchRule branchRule = BranchSupport;
+    bool useTable = false;
+    size_t tableSize = 1 << 22;
+    bool plan = false;
+    bool components = false;
+    long long componentNodes = 20000;
+    bool downward = false;
+    long long downwardNodes = 20000;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--count") counting = true;
+        if (arg == "--threads" && i + 1 < argc) threads = max(1, atoi(argv[++i]));
+        if (arg == "--split-nodes" && i + 1 < argc) splitNodes = atoll(argv[++i]);
+        if (arg == "--lagrange") lagrange = true;
+        if (arg == "--lagrange-iters" && i + 1 < argc) lagrangeIters = atoi(argv[++i]);
+        if (arg == "--branch" && i + 1 < argc) {
+            branchRule = parseBranchRule(argv[++i]);
+            if (branchRule == NumBranchRules) {
+                cerr << "Unknown branching rule " << argv[i] << " (support, marginal, wdeg, dual, entropy)\n";
+                return 1;
+            }
+        }
+        if (arg == "--plan") plan = true;
+        if (arg == "--components") components = true;
+        if (arg == "--component-nodes" && i + 1 < argc) componentNodes = atoll(argv[++i]);
+        if (arg == "--downward") downward = true;
+        if (arg == "--downward-nodes" && i + 1 < argc) downwardNodes = atoll(argv[++i]);
+        if (arg == "--table") useTable = true;
+        if (arg == "--table-size" && i + 1 < argc) tableSize = atoll(argv[++i]);
+        if (arg == "--cert" && i + 1 < argc) certPath = argv[++i];
+        if (arg == "--profile" && i + 1 < argc) profilePath = argv[++i];
+    }
+
+    vector<bitset<maxM>> nearZero = buildNearZero();
+
+    auto t_start = chrono::high_resolution_clock::now();
+
+    vector<int> candidates = initialCandidates();
+    int numCandidatesInitial = (int)candidates.size();
+    cerr << "Initial candidates: " << numCandidatesInitial << "\n";
+
+    vector<int> primeDivisors = getPrimeDivisors(n);
+    // Certificates log every removal for the checker, so planned (partial)
+    // passes certify as well as full ones
+    ReductionLog velocitySteps, timeSteps;
+    bool logSteps = !certPath.empty();
+    PassPlan velocityPlan, timePlan;
+    // A covering through a dominated velocity maps to one without it, so
+    // velocity dominance keeps the verdict but not the number of coverings
+    bool exactCount = counting && certPath.empty();
+    if (exactCount) {
+        velocityPlan.name = "velocity dominance";
+        velocityPlan.depth = 0;
+        cerr << "Velocity dominance: skipped (--count)\n";
+    } else if (plan) {
+        velocityPlan = planVelocityDominance(candidates, nearZero, primeDivisors);
+        velocityPlan.report(cerr);
+    }
+    candidates = reduceCandidatesByDominance(candidates, nearZero, primeDivisors, velocityPlan.depth,
+                                             logSteps ? &velocitySteps : nullptr);
+    cerr << "After velocity dominance: " << candidates.size()
+         << " (eliminated " << (numCandidatesInitial - candidates.size()) << ")\n";
+
+    auto coverSets = buildCoverageSets(candidates, nearZero);
+    if (plan) {
+        timePlan = planTimeDominance(coverSets);
+        timePlan.report(cerr);
+    }
+    vector<int> essentialTimes = reduceTimesByDominance(coverSets, timePlan.depth, logSteps ? &timeSteps : nullptr);
+    cerr << "After time dominance: " << essentialTimes.size()
+         << " (eliminated " << (maxM - essentialTimes.size()) << ")\n";
+
+    auto t_preprocess_end = chrono::high_resolution_clock::now();
+    cerr << "Total preprocessing: "
+         << chrono::duration<double>(t_preprocess_end - t_start).count() << "s\n\n";
+
+    // Equivalence classes over the essential times, as velocity lists
+    auto classIndices = groupEquivalentCandidates(candidates, nearZero, essentialTimes, primeDivisors);
+    vector<vector<int>> classes;
+    size_t largest = 0;
+    for (const auto& cls : classIndices) {
+        classes.push_back({});
+        for (int j : cls) classes.back().push_back(candidates[j]);
+        largest = max(largest, cls.size());
+    }
+    cerr << "Equivalence classes: " << classes.size() << " (largest " << largest << ")\n";
+
+    ofstream cert;
+    vector<vector<int>> orbits;
+    if (!certPath.empty()) {
+        // Certificates branch on plain candidates so the checker needs no classes
+        classes.clear();
+        for (int v : candidates) classes.push_back({ v });
+
+        int groupOrder;
+        vector<int> gens = unitGroupGenerators(groupOrder);
+        vector<char> isCandidate(maxM + 1, 0);
+        for (int v : candidates) isCandidate[v] = 1;
+        for (int g : gens) {
+            for (int v : candidates) {
+                if (!isCandidate[foldMod((long long)v * g)]) {
+                    cerr << "Reduced candidates not closed under unit " << g << ", no symmetry\n";
+                    gens.clear();
+                    groupOrder = 1;
+                    break;
+                }
+            }
+        }
+        orbits = candidateOrbits(candidates, gens);
+        cerr << "Symmetry: group order " << groupOrder << ", " << gens.size()
+             << " generators, " << orbits.size() << " orbits\n";
+
+        cert.open(certPath);
+        cert << "p lonely " << k << " " << prime << "\n";
+        writeReductionSteps(cert, velocitySteps, timeSteps);
+        cert << "g";
+        for (int g : gens) cert << " " << g;
+        cert << " 0\no";
+        for (const auto& orbit : orbits) cert << " " << orbit[0];
+        cert << " 0\n";
+    }
+
+    NativeSearch search(classes, nearZero, essentialTimes, primeDivisors);
+    search.counting = exactCount;
+    if (cert.is_open()) search.proof = &cert;
+    // The certificate checker replays only the plain coverage-sum bound
+    search.lagrange = (lagrange || branchRule == BranchDual) && !cert.is_open();
+    // The dual rule reads λ, which only the Lagrangian bound maintains
+    search.branchRule = branchRule == BranchDual && !search.lagrange ? BranchSupport : branchRule;
+    search.lagrangeIters = lagrangeIters;
+    // Verdicts only: counting needs every subtree's total, certificates a tree
+    ResidualTable table(tableSize);
+    if (useTable && !search.counting && !cert.is_open()) {
+        search.table = &table;
+        search.setSymmetry(unitGroupElements());
+    }
+    // Verdicts only, like the table: a combined subtree has no single tree
+    search.components = components && !search.counting && !cert.is_open();
+    search.componentNodeLimit = componentNodes;
+    if (!profilePath.empty()) {
+        search.profile.enabled = true;
+        search.profile.staticPrunes[PruneStaticDominance] =
+            numCandidatesInitial - (long long)candidates.size() + maxM - (long long)essentialTimes.size();
+    }
+    cerr << "Branching: " << branchRuleNames[search.branchRule] << "\n";
+    bool found = false;
+    // Quick SAT tiers: covers by k-2, then k-1 candidates. Not with
+    // counting or certificates, which need the full exactly-k tree
+    if (downward && !search.counting && !cert.is_open()) {
+        for (int cover = max(1, k - 2); cover < k && !found; ++cover) {
+            long long before = search.nodes;
+            found = search.searchDownward(cover, downwardNodes);
+            cerr << "Downward: " << cover << " covering velocities: "
+                 << (found ? "found" : search.overLimit ? "over the node limit" : "none") << " ("
+                 << search.nodes - before << " nodes)\n";
+        }
+    }
+    if (!found && threads > 1 && !cert.is_open()) {
+        // Every worker gets its own copy of the search state
+        WorkQueue<SplitTask> pool(threads);
+        pool.push({});
+        vector<NativeSearch> workers(threads, search);
+        mutex resultLock;
+        vector<thread> running;
+        for (auto& w : workers) {
+            w.pool = &pool;
+            w.splitNodes = splitNodes;
+            w.profile = SearchProfile();
+            w.profile.enabled = search.profile.enabled;
+            running.emplace_back([&] {
+                SplitTask task;
+                while (pool.pop(task)) {
+                    if (!w.runTask(task)) continue;
+                    lock_guard<mutex> lock(resultLock);
+                    if (search.solution.empty()) search.solution = w.solution;
+                    pool.stop();
+                }
+            });
+        }
+        for (auto& t : running) t.join();
+        for (auto& w : workers) {
+            search.nodes += w.nodes;
+            search.boundPrunes += w.boundPrunes;
+            search.lagrangePrunes += w.lagrangePrunes;
+            search.tableHits += w.tableHits;
+            search.componentSplits += w.componentSplits;
+            search.componentPrunes += w.componentPrunes;
+            search.componentAborts += w.componentAborts;
+            search.coverings += w.coverings;
+            search.profile.merge(w.profile);
+            if (search.solution.empty()) search.solution = w.solution;
+        }
+        found = !search.solution.empty();
+        cerr << "Parallel: " << threads << " workers, " << pool.tasksPushed() << " tasks\n";
+    } else if (!found) {
+        found = cert.is_open() ? search.searchByOrbits(orbits) : search.search();
+    }
+    if (search.counting) found = search.coverings > 0;
+    auto t_search_end = chrono::high_resolution_clock::now();
+
+    cerr << "Search: " << search.nodes << " nodes, "
+         << search.boundPrunes << " bound prunes, "
+         << search.lagrangePrunes << " Lagrangian prunes, "
+         << chrono::duration<double>(t_search_end - t_preprocess_end).count() << "s\n";
+    if (search.table) {
+        cerr << "Residual table: " << search.tableHits << " hits, " << table.size() << " entries, "
+             << search.timeImage.size() << " unit maps\n";
+    }
+    if (search.components) {
+        cerr << "Components: " << search.componentSplits << " split nodes, " << search.componentPrunes
+             << " refuted by the budget DP, " << search.componentAborts << " over the node limit\n";
+    }
+
+    if (cert.is_open()) {
+        if (found) {
+            cert << "w";
+            for (int v : search.solution) cert << " " << v;
+            cert << " 0\n";
+        }
+        cerr << "Certificate: " << certPath << " (" << cert.tellp() << " bytes)\n";
+    }
+    if (search.profile.enabled) {
+        ofstream out(profilePath);
+        search.profile.write(out);
+        search.profile.summary(cerr);
+        cerr << "Profile: " << profilePath << "\n";
+    }
+    if (search.counting) cout << "c coverings " << toString(search.coverings) << "\n";
+    if (found) {
+        cout << "s SATISFIABLE\nv";
+        for (int v : search.solution) cout << " " << v;
+        cout << " 0\n";
+    } else {
+        cout << "s UNSATISFIABLE\n";
+    }
+    reportPeakRss(cerr);
+    return 0;
+}
@@ -0,0 +1,131 @@
+// Cost-aware preprocessing planner (--plan)
+//
+// The dominance passes compare all pairs: O(n²·words) for n candidates or
+// times. On most of the sweep they remove almost nothing, and on tiny
+// instances they cost more than the solve. For each pass the planner times
+// a fixed-seed sample of random pairs with the pass's own test. From that it
+// extrapolates the cost of the full pass and estimates the removals from
+// the hit rate. Then:
+//   - a pass smaller than the sample, or estimated under kPlanFloorSeconds,
+//     just runs: too cheap to be worth skipping;
+//   - a pass whose expected removals, at kPlanRemovalSeconds of solve time
+//     saved each, do not pay for its estimated cost is skipped;
+//   - otherwise the pass runs, but only with dominators up to twice the
+//     deepest sampled hit, in preference order (largest cover first for
+//     velocities, smallest first for times).
+// The saving per removal is a fixed estimate: the solve time is unknown
+// before preprocessing ends.
+// Skipping or cutting a pass is always sound, since a dominance removal is
+// optional. Certificates log the removals actually made, so the checker
+// follows a planned reduction as well as a full one.
+
+#pragma once
+
+#include <cmath>
+#include <iomanip>
+#include <random>
+#include "lonely_common.hpp"
+
+struct PassPlan {
+    string name;
+    int depth = -1;             // dominators tried: -1 all (index order), 0 skip
+    long long sampled = 0;
+    long long hits = 0;
+    double fullSeconds = 0;     // extrapolated cost of the full pass
+    double expectedRemoved = 0;
+
+    void report(ostream& out) const {
+        out << "Plan: " << name << ": "
+            << (depth == 0 ? "skip" : depth < 0 ? "run" : "run to depth " + to_string(depth));
+        if (sampled) {
+            out << " (" << hits << "/" << sampled << " sampled pairs, ~" << fixed << setprecision(1)
+                << expectedRemoved << " removals, full pass ~" << setprecision(3) << fullSeconds * 1e3 << "ms)";
+            out.unsetf(ios::floatfield);
+            out << setprecision(6);
+        }
+        out << "\n";
+    }
+};
+
+constexpr int kPlanSamplePairs = 2000;
+constexpr double kPlanFloorSeconds = 2e-3;
+constexpr double kPlanRemovalSeconds = 1e-3;
+
+// order: items by dominator preference; dominates(a, b) is the pass's test
+template <class Test>
+PassPlan planPass(const string& name, const vector<int>& order, Test dominates) {
+    PassPlan plan;
+    plan.name = name;
+    long long count = (long long)order.size();
+    long long pairs = count * (count - 1);
+    if (pairs <= 2LL * kPlanSamplePairs) return plan;
+
+    vector<int> rankOf(order.size());
+    for (int r = 0; r < (int)order.size(); ++r) rankOf[order[r]] = r;
+
+    mt19937 rng(12345);
+    uniform_int_distribution<int> pick(0, (int)count - 1);
+    int deepest = -1;
+    auto start = chrono::high_resolution_clock::now();
+    for (int s = 0; s < kPlanSamplePairs; ++s) {
+        int a = pick(rng), b = pick(rng);
+        if (a == b) b = (b + 1) % (int)count;
+        if (dominates(a, b)) {
+            ++plan.hits;
+            deepest = max(deepest, rankOf[a]);
+        }
+    }
+    double sampleSeconds = chrono::duration<double>(chrono::high_resolution_clock::now() - start).count();
+    plan.sampled = kPlanSamplePairs;
+    plan.fullSeconds = sampleSeconds * pairs / kPlanSamplePairs;
+
+    double rate = (double)plan.hits / plan.sampled;
+    plan.expectedRemoved = count * (1 - pow(1 - rate, (double)(count - 1)));
+    if (plan.fullSeconds <= kPlanFloorSeconds) return plan;
+    if (plan.expectedRemoved * kPlanRemovalSeconds < plan.fullSeconds) {
+        plan.depth = 0;
+    } else if (2LL * (deepest + 1) < count) {
+        plan.depth = 2 * (deepest + 1);
+    }
+    return plan;
+}
+
+// Velocity dominance over the initial candidates
+PassPlan planVelocityDominance(const vector<int>& candidates, const vector<bitset<maxM>>& nearZero,
+                               const vector<int>& primeDivisors) {
+    vector<int> order = velocityDominatorOrder(candidates, nearZero);
+    return planPass("velocity dominance", order, [&](int a, int b) {
+        return dominatesVelocity(candidates[a], candidates[b], nearZero, primeDivisors);
+    });
+}
+
+// Time dominance over the coverage sets
+PassPlan planTimeDominance(const vector<bitset<10000>>& cover) {
+    vector<int> order = timeDominatorOrder(cover);
+    return planPass("time dominance", order, [&](int a, int b) {
+        return (cover[a] | cover[b]) == cover[b];
+    });
+}
+
+// Conditional dominance (CNF generator): pairs over the essential times
+// where the first covers the second and ranks above it. Its yield is
+// clauses rather than removals, so the planner only decides run or skip.
+PassPlan planConditionalDominance(const vector<int>& candidates, const vector<bitset<maxM>>& nearZero,
+                                  const vector<int>& essentialTimes) {
+    bitset<maxM> essentialMask;
+    for (int t : essentialTimes) essentialMask[t] = true;
+    int numCand = (int)candidates.size();
+    vector<bitset<maxM>> cover(numCand);
+    vector<int> size(numCand), order(numCand);
+    for (int j = 0; j < numCand; ++j) {
+        cover[j] = nearZero[candidates[j]] & essentialMask;
+        size[j] = (int)cover[j].count();
+        order[j] = j;
+    }
+    PassPlan plan = planPass("conditional dominance", order, [&](int a, int b) {
+        if (size[a] < size[b] || (size[a] == size[b] && a > b)) return false;
+        return (cover[a] | cover[b]) == cover[a];
+    });
+    if (plan.depth > 0) plan.depth = -1;
+    return plan;
+}
@@ -0,0 +1,100 @@
+// Shared table of refuted residual instances for the native search
+//
+// A residual instance is what is left below a search node: the uncovered
+// times, the still-available candidates that can touch them, the remaining
+// slots and the GCD and padding budgets. The search splits it into an exact
+// key (canonical under the ±unit group) and a bit row of resources, where
+// fewer resources is a subset. An instance is refuted if an entry under the
+// same key has a superset row: that instance, or one of its images, was
+// searched to exhaustion with at least as much and found no covering.
+// Workers share one table; it is sharded by hash so they rarely contend,
+// and stops growing at capacity.
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+using namespace std;
+
+class ResidualTable {
+public:
+    explicit ResidualTable(size_t capacity) : capacity(capacity) {}
+
+    // Some entry under key covers one of the rows
+    bool refutes(const vector<uint64_t>& key, const vector<vector<uint64_t>>& rows) const {
+        const Shard& s = shardOf(key);
+        lock_guard<mutex> lock(s.m);
+        auto it = s.entries.find(key);
+        if (it == s.entries.end()) return false;
+        for (const auto& entry : it->second) {
+            for (const auto& row : rows) {
+                if (subset(row, entry)) return true;
+            }
+        }
+        return false;
+    }
+
+    // Record a refuted instance; entries it covers are dropped
+    void insert(const vector<uint64_t>& key, const vector<uint64_t>& row) {
+        Shard& s = shardOf(key);
+        lock_guard<mutex> lock(s.m);
+        auto it = s.entries.find(key);
+        if (it == s.entries.end()) {
+            if (stored.load(memory_order_relaxed) >= capacity) return;
+            it = s.entries.emplace(key, vector<vector<uint64_t>>{}).first;
+        }
+        auto& list = it->second;
+        for (const auto& entry : list) {
+            if (subset(row, entry)) return;
+        }
+        size_t before = list.size();
+        list.erase(remove_if(list.begin(), list.end(), [&](const auto& entry) { return subset(entry, row); }),
+                   list.end());
+        if (list.size() >= kMaxRows) list.erase(list.begin());
+        list.push_back(row);
+        stored.fetch_add(list.size() - before, memory_order_relaxed);
+    }
+
+    size_t size() const { return stored.load(memory_order_relaxed); }
+
+private:
+    struct KeyHash {
+        size_t operator()(const vector<uint64_t>& key) const {
+            uint64_t h = 0x9e3779b97f4a7c15ULL;
+            for (uint64_t w : key) {
+                h ^= w + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+                h *= 0xff51afd7ed558ccdULL;
+            }
+            return (size_t)(h ^ (h >> 33));
+        }
+    };
+
+    struct Shard {
+        mutable mutex m;
+        unordered_map<vector<uint64_t>, vector<vector<uint64_t>>, KeyHash> entries;
+    };
+
+    static constexpr int kShards = 64;
+    static constexpr size_t kMaxRows = 16;   // per key, oldest dropped first
+
+    static bool subset(const vector<uint64_t>& a, const vector<uint64_t>& b) {
+        for (size_t w = 0; w < a.size(); ++w) {
+            if (a[w] & ~b[w]) return false;
+        }
+        return true;
+    }
+
+    Shard& shardOf(const vector<uint64_t>& key) { return shards[KeyHash()(key) >> 7 & (kShards - 1)]; }
+    const Shard& shardOf(const vector<uint64_t>& key) const {
+        return shards[KeyHash()(key) >> 7 & (kShards - 1)];
+    }
+
+    size_t capacity;
+    atomic<size_t> stored{ 0 };
+    array<Shard, kShards> shards;
+};
@@ -0,0 +1,146 @@
+// Search-tree profile for the native engine
+//
+// Per depth (number of chosen velocities): nodes, children generated and
+// the rule that cut each pruned subtree. Per node kind: count and time spent
+// in the node's own work (selection, scoring, bounds), excluding children.
+// Written as a whitespace-separated histogram plus a summary table.
+// Parallel workers keep their own profile and are merged at the end, so
+// node-kind seconds are summed over threads (CPU time, not wall time).
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <iomanip>
+#include <ostream>
+#include <string>
+#include <vector>
+using namespace std;
+
+enum PruneRule {
+    PruneStaticDominance,   // candidates/times removed before search
+    PruneGcdLimit,          // child skipped: its GCD class is full
+    PruneNoSupport,         // an uncovered time has no available candidate
+    PruneCoverageSum,       // best remaining scores cannot reach |U|
+    PruneLagrange,          // weighted (Lagrangian) coverage-sum bound
+    PruneTransposition,     // residual instance already refuted (--table)
+    PruneComponents,        // independent parts cannot share the budget (--components)
+    PruneLastSlot,          // no single candidate covers the rest
+    PruneNoPadding,         // covered, but no k-set completion fits
+    PruneBudget,            // k chosen, times still uncovered
+    NumPruneRules
+};
+
+static const char* pruneRuleNames[NumPruneRules] = {
+    "static_dominance", "gcd_limit", "no_support", "coverage_sum",
+    "lagrange", "transposition", "components", "last_slot", "no_padding", "k_used"
+};
+
+enum NodeKind { NodeBranch, NodeLastSlot, NodeLeaf, NodePruned, NumNodeKinds };
+
+static const char* nodeKindNames[NumNodeKinds] = { "branch", "last_slot", "leaf", "pruned" };
+
+struct SearchProfile {
+    typedef chrono::steady_clock Clock;
+
+    bool enabled = false;
+    vector<long long> nodes;
+    vector<long long> children;
+    vector<array<long long, NumPruneRules>> prunes;
+    array<long long, NumPruneRules> staticPrunes{};
+    array<long long, NumNodeKinds> kindCount{};
+    array<double, NumNodeKinds> kindSeconds{};
+
+    void grow(int depth) {
+        if ((int)nodes.size() <= depth) {
+            nodes.resize(depth + 1, 0);
+            children.resize(depth + 1, 0);
+            prunes.resize(depth + 1, array<long long, NumPruneRules>{});
+        }
+    }
+
+    Clock::time_point enter(int depth) {
+        grow(depth);
+        ++nodes[depth];
+        return Clock::now();
+    }
+
+    // Node's own work ends here (before recursing or returning)
+    void leave(NodeKind kind, Clock::time_point start) {
+        ++kindCount[kind];
+        kindSeconds[kind] += chrono::duration<double>(Clock::now() - start).count();
+    }
+
+    void prune(int depth, PruneRule rule, long long count = 1) {
+        grow(depth);
+        prunes[depth][rule] += count;
+    }
+
+    void branch(int depth, long long count) {
+        grow(depth);
+        children[depth] += count;
+    }
+
+    // Add a worker's counts; the static prunes are the caller's own
+    void merge(const SearchProfile& other) {
+        grow((int)other.nodes.size() - 1);
+        for (size_t d = 0; d < other.nodes.size(); ++d) {
+            nodes[d] += other.nodes[d];
+            children[d] += other.children[d];
+            for (int r = 0; r < NumPruneRules; ++r) prunes[d][r] += other.prunes[d][r];
+        }
+        for (int kd = 0; kd < NumNodeKinds; ++kd) {
+            kindCount[kd] += other.kindCount[kd];
+            kindSeconds[kd] += other.kindSeconds[kd];
+        }
+    }
+
+    // Histogram: one row per depth, then one row per node kind
+    void write(ostream& out) const {
+        out << "# depth nodes children branching";
+        for (const char* name : pruneRuleNames) out << " " << name;
+        out << "\n";
+        out << "static 0 0 0";
+        for (long long c : staticPrunes) out << " " << c;
+        out << "\n";
+        for (size_t d = 0; d < nodes.size(); ++d) {
+            double b = nodes[d] ? (double)children[d] / nodes[d] : 0.0;
+            out << d << " " << nodes[d] << " " << children[d] << " " << b;
+            for (long long c : prunes[d]) out << " " << c;
+            out << "\n";
+        }
+        out << "# kind count seconds ns_per_node\n";
+        for (int kd = 0; kd < NumNodeKinds; ++kd) {
+            out << nodeKindNames[kd] << " " << kindCount[kd] << " " << kindSeconds[kd] << " "
+                << (kindCount[kd] ? 1e9 * kindSeconds[kd] / kindCount[kd] : 0.0) << "\n";
+        }
+    }
+
+    void summary(ostream& out) const {
+        array<long long, NumPruneRules> total = staticPrunes;
+        long long totalNodes = 0;
+        for (size_t d = 0; d < nodes.size(); ++d) {
+            totalNodes += nodes[d];
+            for (int r = 0; r < NumPruneRules; ++r) total[r] += prunes[d][r];
+        }
+
+        out << "\nSearch profile: " << totalNodes << " nodes\n";
+        out << "  depth        nodes   branching\n";
+        for (size_t d = 0; d < nodes.size(); ++d) {
+            out << "  " << setw(5) << d << setw(13) << nodes[d] << setw(12) << fixed << setprecision(2)
+                << (nodes[d] ? (double)children[d] / nodes[d] : 0.0) << "\n";
+        }
+        out << "  prune rule          subtrees\n";
+        for (int r = 0; r < NumPruneRules; ++r) {
+            out << "  " << left << setw(18) << pruneRuleNames[r] << right << setw(10) << total[r] << "\n";
+        }
+        out << "  node kind       count     seconds   ns/node\n";
+        for (int kd = 0; kd < NumNodeKinds; ++kd) {
+            out << "  " << left << setw(10) << nodeKindNames[kd] << right << setw(11) << kindCount[kd]
+                << setw(12) << setprecision(4) << kindSeconds[kd] << setw(10) << setprecision(0)
+                << (kindCount[kd] ? 1e9 * kindSeconds[kd] / kindCount[kd] : 0.0) << "\n";
+        }
+        out.unsetf(ios::floatfield);
+        out << setprecision(6);
+    }
+};
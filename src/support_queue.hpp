@@ -0,0 +1,85 @@
+// Bucket queue of uncovered times keyed by support
+//
+// support[t] = number of available candidates covering time t. Counts are
+// updated as candidates are excluded and restored (O(|cover(v)|) per
+// change); times enter and leave the queue as they become uncovered or
+// covered. Buckets are unordered arrays with swap-remove, and the minimum
+// is found from a lower-bound hint that only moves up while scanning.
+
+#pragma once
+
+#include <vector>
+using namespace std;
+
+class SupportQueue {
+public:
+    SupportQueue() = default;
+
+    SupportQueue(int numTimes, int maxSupport)
+        : support(numTimes, 0), pos(numTimes, -1), buckets(maxSupport + 1) {}
+
+    // Initial support of t, before it is inserted
+    void setSupport(int t, int s) { support[t] = s; }
+    int supportOf(int t) const { return support[t]; }
+    bool contains(int t) const { return pos[t] >= 0; }
+    int size() const { return count; }
+
+    void insert(int t) {
+        int s = support[t];
+        pos[t] = (int)buckets[s].size();
+        buckets[s].push_back(t);
+        if (s < minHint) minHint = s;
+        ++count;
+    }
+
+    void erase(int t) {
+        detach(t);
+        pos[t] = -1;
+        --count;
+    }
+
+    // One candidate covering t became unavailable / available again
+    void decrement(int t) {
+        if (pos[t] < 0) { --support[t]; return; }
+        detach(t);
+        int s = --support[t];
+        pos[t] = (int)buckets[s].size();
+        buckets[s].push_back(t);
+        if (s < minHint) minHint = s;
+    }
+
+    void increment(int t) {
+        if (pos[t] < 0) { ++support[t]; return; }
+        detach(t);
+        int s = ++support[t];
+        pos[t] = (int)buckets[s].size();
+        buckets[s].push_back(t);
+    }
+
+    // A queued time of minimum support, or -1 if the queue is empty
+    int minTime() {
+        if (count == 0) return -1;
+        while (buckets[minHint].empty()) ++minHint;
+        return buckets[minHint].back();
+    }
+
+    // Times currently queued with support s, in no particular order
+    const vector<int>& bucket(int s) const { return buckets[s]; }
+    int maxSupport() const { return (int)buckets.size() - 1; }
+
+private:
+    void detach(int t) {
+        auto& b = buckets[support[t]];
+        int p = pos[t];
+        int last = b.back();
+        b[p] = last;
+        pos[last] = p;
+        b.pop_back();
+    }
+
+    vector<int> support;
+    vector<int> pos;
+    vector<vector<int>> buckets;
+    int minHint = 0;
+    int count = 0;
+};
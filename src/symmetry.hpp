@@ -0,0 +1,83 @@
+// ±unit group action on velocities and times
+//
+// For u coprime to Q, v -> ±uv mod Q together with t -> ±t/u mod Q keeps
+// t·v mod Q fixed, so it maps coverings to coverings. It fixes pZ and the
+// multiples of every q | n, so the prime exclusion and the GCD limits are
+// preserved as well. Velocities and times are folded into [1..maxM].
+
+#pragma once
+
+#include <numeric>
+#include "lonely_common.hpp"
+
+inline int foldMod(long long x) {
+    int r = (int)(((x % Q) + Q) % Q);
+    return r > maxM ? Q - r : r;
+}
+
+inline int unitInverse(int u) {
+    for (int x = 1; x < Q; ++x) {
+        if ((long long)u * x % Q == 1) return x;
+    }
+    return 0;
+}
+
+// Generators of (Z/QZ)* / {±1}, chosen greedily in increasing order
+vector<int> unitGroupGenerators(int& groupOrder) {
+    vector<char> inGroup(maxM + 1, 0);
+    vector<int> elements = { 1 };
+    inGroup[1] = 1;
+    vector<int> gens;
+
+    for (int u = 2; u <= maxM; ++u) {
+        if (gcd(u, Q) != 1 || inGroup[u]) continue;
+        gens.push_back(u);
+        // Close the subgroup under all generators so far
+        for (size_t i = 0; i < elements.size(); ++i) {
+            for (int g : gens) {
+                int x = foldMod((long long)elements[i] * g);
+                if (!inGroup[x]) {
+                    inGroup[x] = 1;
+                    elements.push_back(x);
+                }
+            }
+        }
+    }
+    groupOrder = (int)elements.size();
+    return gens;
+}
+
+// Every element of (Z/QZ)* / {±1}, folded into [1..maxM], identity first
+vector<int> unitGroupElements() {
+    vector<int> elements;
+    for (int u = 1; u <= maxM; ++u) {
+        if (gcd(u, Q) == 1) elements.push_back(u);
+    }
+    return elements;
+}
+
+// Orbits of the candidates under the generators, ordered by smallest
+// member; each orbit is a sorted list of velocities
+vector<vector<int>> candidateOrbits(const vector<int>& candidates, const vector<int>& gens) {
+    vector<int> orbitOf(maxM + 1, -1);
+    vector<char> isCandidate(maxM + 1, 0);
+    for (int v : candidates) isCandidate[v] = 1;
+
+    vector<vector<int>> orbits;
+    for (int v : candidates) {
+        if (orbitOf[v] >= 0) continue;
+        orbits.push_back({ v });
+        orbitOf[v] = (int)orbits.size() - 1;
+        for (size_t i = 0; i < orbits.back().size(); ++i) {
+            for (int g : gens) {
+                int w = foldMod((long long)orbits.back()[i] * g);
+                if (isCandidate[w] && orbitOf[w] < 0) {
+                    orbitOf[w] = orbitOf[v];
+                    orbits.back().push_back(w);
+                }
+            }
+        }
+        sort(orbits.back().begin(), orbits.back().end());
+    }
+    return orbits;
+}
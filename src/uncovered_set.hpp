@@ -0,0 +1,144 @@
+// Uncovered-time set for the native search
+//
+// Plain word array plus a two-level summary: mid has one bit per non-zero
+// 64-bit word, top has one bit per non-zero mid word. Intersections,
+// popcounts and first-element queries walk only the non-zero words, so the
+// per-node cost follows |U| instead of the full row width. Removals are
+// trailed word by word and undone in LIFO order during backtracking.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <bitset>
+#include <cassert>
+using namespace std;
+
+// Copy the low nbits of a bitset into 64-bit words
+template <size_t N>
+vector<uint64_t> toWords(const bitset<N>& bits, int nbits) {
+    vector<uint64_t> words((nbits + 63) / 64, 0);
+    for (int i = 0; i < nbits; ++i) {
+        if (bits[i]) words[i >> 6] |= 1ULL << (i & 63);
+    }
+    return words;
+}
+
+class UncoveredSet {
+public:
+    explicit UncoveredSet(int nbits = 0)
+        : numBits(nbits), words((nbits + 63) / 64, 0), mid((words.size() + 63) / 64, 0) {
+        assert(mid.size() <= 64);
+    }
+
+    void insert(int bit) {
+        int w = bit >> 6;
+        if (!(words[w] >> (bit & 63) & 1)) ++size;
+        words[w] |= 1ULL << (bit & 63);
+        mid[w >> 6] |= 1ULL << (w & 63);
+        top |= 1ULL << (w >> 6);
+    }
+
+    bool empty() const { return top == 0; }
+    int count() const { return size; }
+    int bits() const { return numBits; }
+    const uint64_t* data() const { return words.data(); }
+
+    bool contains(int bit) const { return words[bit >> 6] >> (bit & 63) & 1; }
+
+    // Smallest element, or -1 if empty
+    int first() const {
+        if (!top) return -1;
+        int m = __builtin_ctzll(top);
+        int w = (m << 6) | __builtin_ctzll(mid[m]);
+        return (w << 6) | __builtin_ctzll(words[w]);
+    }
+
+    // f(wordIndex, word) for every non-zero word, in increasing order
+    template <class F>
+    void forEachWord(F f) const {
+        for (uint64_t tm = top; tm; tm &= tm - 1) {
+            int m = __builtin_ctzll(tm);
+            for (uint64_t mm = mid[m]; mm; mm &= mm - 1) {
+                int w = (m << 6) | __builtin_ctzll(mm);
+                f(w, words[w]);
+            }
+        }
+    }
+
+    // f(bit) for every element, in increasing order
+    template <class F>
+    void forEach(F f) const {
+        forEachWord([&](int w, uint64_t x) {
+            for (; x; x &= x - 1) f((w << 6) | __builtin_ctzll(x));
+        });
+    }
+
+    // |U ∩ row|
+    int intersectCount(const uint64_t* row) const {
+        int c = 0;
+        forEachWord([&](int w, uint64_t x) { c += __builtin_popcountll(x & row[w]); });
+        return c;
+    }
+
+    // U ∩ row non-empty
+    bool intersects(const uint64_t* row) const {
+        for (uint64_t tm = top; tm; tm &= tm - 1) {
+            int m = __builtin_ctzll(tm);
+            for (uint64_t mm = mid[m]; mm; mm &= mm - 1) {
+                int w = (m << 6) | __builtin_ctzll(mm);
+                if (words[w] & row[w]) return true;
+            }
+        }
+        return false;
+    }
+
+    // U ⊆ row
+    bool subsetOf(const uint64_t* row) const {
+        bool ok = true;
+        forEachWord([&](int w, uint64_t x) { ok &= (x & ~row[w]) == 0; });
+        return ok;
+    }
+
+    // U \= row, recording changed words for undo()
+    void subtract(const uint64_t* row) {
+        for (uint64_t tm = top; tm; tm &= tm - 1) {
+            int m = __builtin_ctzll(tm);
+            for (uint64_t mm = mid[m]; mm; mm &= mm - 1) {
+                int w = (m << 6) | __builtin_ctzll(mm);
+                uint64_t old = words[w];
+                uint64_t nw = old & ~row[w];
+                if (nw == old) continue;
+                trail.push_back({ w, old });
+                size -= __builtin_popcountll(old ^ nw);
+                words[w] = nw;
+                if (!nw) {
+                    mid[m] &= ~(1ULL << (w & 63));
+                    if (!mid[m]) top &= ~(1ULL << m);
+                }
+            }
+        }
+    }
+
+    size_t mark() const { return trail.size(); }
+
+    // Restore every word changed since mark
+    void undo(size_t m) {
+        while (trail.size() > m) {
+            auto [w, old] = trail.back();
+            trail.pop_back();
+            size += __builtin_popcountll(old ^ words[w]);
+            words[w] = old;
+            mid[w >> 6] |= 1ULL << (w & 63);
+            top |= 1ULL << (w >> 6);
+        }
+    }
+
+private:
+    int numBits = 0;
+    int size = 0;
+    vector<uint64_t> words;
+    vector<uint64_t> mid;
+    uint64_t top = 0;
+    vector<pair<int, uint64_t>> trail;
+};
@@ -0,0 +1,75 @@
+// Shared task queue for the parallel engines
+//
+// Workers pop tasks until the queue is empty and every worker is idle, or
+// until stop() is called (e.g. a witness was found). A worker deep in a long
+// task polls wantsWork() and donates part of its remaining work with push()
+// while others are waiting, so splitting adapts to the actual imbalance
+// instead of a fixed cube depth.
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+using namespace std;
+
+template <typename Task>
+class WorkQueue {
+public:
+    explicit WorkQueue(int workers) : workers(workers) {}
+
+    void push(Task task) {
+        {
+            lock_guard<mutex> lock(m);
+            tasks.push_back(move(task));
+            queuedHint.store((int)tasks.size(), memory_order_relaxed);
+            ++pushed;
+        }
+        cv.notify_one();
+    }
+
+    // Blocks until a task is available; false once all work is done or stopped
+    bool pop(Task& task) {
+        unique_lock<mutex> lock(m);
+        ++idle;
+        idleHint.store(idle, memory_order_relaxed);
+        if (idle == workers && tasks.empty()) cv.notify_all();
+        cv.wait(lock, [&] { return stopped || !tasks.empty() || idle == workers; });
+        if (stopped || tasks.empty()) return false;
+        task = move(tasks.front());
+        tasks.pop_front();
+        queuedHint.store((int)tasks.size(), memory_order_relaxed);
+        --idle;
+        idleHint.store(idle, memory_order_relaxed);
+        return true;
+    }
+
+    // Cheap poll for busy workers: more workers waiting than tasks queued
+    bool wantsWork() const {
+        return idleHint.load(memory_order_relaxed) > queuedHint.load(memory_order_relaxed) &&
+               !stopped.load(memory_order_relaxed);
+    }
+
+    void stop() {
+        {
+            lock_guard<mutex> lock(m);
+            stopped = true;
+        }
+        cv.notify_all();
+    }
+
+    bool isStopped() const { return stopped.load(memory_order_relaxed); }
+    long long tasksPushed() const { return pushed; }
+
+private:
+    int workers;
+    int idle = 0;
+    long long pushed = 0;
+    atomic<int> idleHint{ 0 };
+    atomic<int> queuedHint{ 0 };
+    atomic<bool> stopped{ false };
+    deque<Task> tasks;
+    mutex m;
+    condition_variable cv;
+};
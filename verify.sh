@@ -3,6 +3,11 @@
 # Usage: ./verify.sh K [PRIME]
 #   K: number of runners minus 1 (e.g., 7 for 8 runners)
 #   PRIME: specific prime to verify (optional, will verify all if omitted)
+#   ENGINE=native selects the native covering search instead of CNF + kissat
+#     (with the bounded k-2 / k-1 covering tiers first, --downward)
+#   ENGINE=cdcl solves the CNF with the in-tree CDCL solver (--solve)
+#   BACKBONE=1 (with ENGINE=native) seeds --backbone with a covering found
+#     on a SAT case and reports ❌ unless single swaps spread it
 
 set -e
 
@@ -37,6 +42,21 @@ get_primes() {
     esac
 }
 
+# The covering in result_temp.txt must yield coverings by swap
+check_backbone() {
+    local k=$1
+    local p=$2
+    g++ -O3 -march=native -pthread -DK=$k -DPRIME=$p -o backbone_temp src/lonely_cnf_generator.cpp 2>/dev/null
+    local swaps=$(./backbone_temp --backbone --seed result_temp.txt --budget 1000 2>&1 >/dev/null |
+                  grep "^Backbone:.*by swap" | sed 's/.* \([0-9]*\) by swap.*/\1/')
+    rm -f backbone_temp
+    if [ "${swaps:-0}" -gt 0 ]; then
+        echo "  ✅ Backbone: $swaps coverings by swap from the seed"
+    else
+        echo "  ❌ Backbone: no covering by swap from the seed"
+    fi
+}
+
 verify_single() {
     local k=$1
     local p=$2
@@ -44,7 +64,11 @@ verify_single() {
     echo "Verifying k=$k, p=$p..."
     
     # Compile
-    g++ -O3 -march=native -DK=$k -DPRIME=$p -o gen_temp src/lonely_cnf_generator.cpp 2>/dev/null
+    if [ "$ENGINE" = "native" ]; then
+        g++ -O3 -march=native -pthread -DK=$k -DPRIME=$p -o gen_temp src/lonely_native_search.cpp 2>/dev/null
+    else
+        g++ -O3 -march=native -pthread -DK=$k -DPRIME=$p -o gen_temp src/lonely_cnf_generator.cpp 2>/dev/null
+    fi
     
     if [ $? -ne 0 ]; then
         echo "  ❌ Compilation failed"
@@ -52,7 +76,13 @@ verify_single() {
     fi
     
     # Generate and solve
-    ./gen_temp 2>/dev/null | ./solver/kissat --quiet > result_temp.txt 2>&1
+    if [ "$ENGINE" = "native" ]; then
+        ./gen_temp --downward > result_temp.txt 2>/dev/null
+    elif [ "$ENGINE" = "cdcl" ]; then
+        ./gen_temp --solve > result_temp.txt 2>/dev/null
+    else
+        ./gen_temp 2>/dev/null | ./solver/kissat --quiet > result_temp.txt 2>&1
+    fi
     
     # Check result
     if grep -q "^s UNSATISFIABLE" result_temp.txt; then
@@ -61,6 +91,9 @@ verify_single() {
         return 0
     elif grep -q "^s SATISFIABLE" result_temp.txt; then
         echo "  ⚠️  SAT (counterexample found!)"
+        if [ "$BACKBONE" = "1" ] && [ "$ENGINE" = "native" ]; then
+            check_backbone $k $p
+        fi
         rm -f gen_temp result_temp.txt
         return 1
     else